@@ -10,10 +10,12 @@
 #include "common.hpp"
 #include "rng.hpp"
 #include "sha256.hpp"
+#include "ecc_field.hpp"
 #include <NTL/ZZ.h>
 #include <NTL/ZZ_p.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace crypto {
 
@@ -39,6 +41,61 @@ enum class CurveType {
     CUSTOM          // Curva personalizada
 };
 
+/**
+ * @brief Backend de aritmetica de campo para las operaciones Jacobianas
+ * 
+ * - NTL: NTL::ZZ_p generico (por defecto; es el que se mide en la memoria)
+ * - MONTGOMERY: elementos de 4x64 / 6x64 bits en la pila (ecc_field.hpp),
+ *   sin reservas de memoria por operacion de grupo. Si p no cabe en
+ *   6 limbs se usa NTL automaticamente.
+ */
+enum class FieldBackend {
+    NTL,            // NTL::ZZ_p (precision arbitraria)
+    MONTGOMERY      // FpField<N> de tamano fijo en forma de Montgomery
+};
+
+/**
+ * @brief Algoritmo de multiplicacion escalar de ec_scalar_mult_jacobian
+ * 
+ * - BINARY: double-and-add bit a bit (~n/2 sumas; por defecto)
+ * - WNAF: NAF con ventana w (CurveParams::wnaf_width) y tabla de
+ *   multiplos impares, ~n/(w+1) sumas
+ * - LADDER: escalera de Montgomery co-Z, sin saltos dependientes de k
+ *   (ver ec_scalar_mult_ladder). Tambien la usan k*G en claves y firma,
+ *   en lugar de la tabla de base fija, y tiene prioridad sobre GLV
+ * - COMPLETE: ventana fija con las formulas completas de Renes-Costello-
+ *   Batina, en linea recta (ver ec_scalar_mult_complete); mismo uso que
+ *   LADDER
+ */
+enum class ScalarMethod {
+    BINARY,
+    WNAF,
+    LADDER,
+    COMPLETE
+};
+
+/**
+ * @brief Algoritmo de ec_multi_scalar_mult
+ * 
+ * - AUTO: Straus por debajo de MSM_PIPPENGER_THRESHOLD terminos, si no
+ *   Pippenger
+ * - STRAUS: wNAF entrelazado con una tabla por punto
+ * - PIPPENGER: metodo de cubos con ventana elegida segun n
+ */
+enum class MultiScalarMethod {
+    AUTO,
+    STRAUS,
+    PIPPENGER
+};
+
+// Terminos (tras la particion GLV) a partir de los que AUTO usa Pippenger
+constexpr size_t MSM_PIPPENGER_THRESHOLD = 128;
+
+/**
+ * @brief Precalculos asociados a una curva (definido en ecc.cpp)
+ */
+struct CurveCache;
+
 /**
  * @brief Parametros de una curva eli­ptica
  * 
@@ -63,11 +120,37 @@ struct CurveParams {
     std::string name;   // Nombre de la curva (para debugging)
     int bits;           // Tamai±o en bits (para referencia)
     
+    // Backend de campo usado por ec_scalar_mult_jacobian (y por tanto por
+    // keygen/ECDH/ECDSA con use_jacobian = true)
+    FieldBackend backend = FieldBackend::NTL;
+    
+    // Algoritmo de ec_scalar_mult_jacobian y ancho de ventana para WNAF
+    ScalarMethod scalar_method = ScalarMethod::BINARY;
+    int wnaf_width = 4;
+    
+    // Usar el endomorfismo GLV si la curva lo tiene (secp256k1): sustituye
+    // a scalar_method en ec_scalar_mult_jacobian, ECDH y la verificacion
+    bool use_endomorphism = true;
+    
+    // Memoria maxima (bytes estimados) de la cache LRU de tablas por clave
+    // publica que usan ECDH y la verificacion en Jacobianas; 0 = desactivada.
+    // La cache es de la curva (compartida entre copias de CurveParams)
+    size_t key_cache_bytes = 0;
+    
     /**
      * @brief Constructor por defecto
      */
     CurveParams() = default;
     
+    /**
+     * @brief Precalculos de la curva (contexto ZZ_p, campo de tamano fijo, ...)
+     * 
+     * Se construyen una sola vez, en el primer uso, y se comparten entre
+     * copias de CurveParams. Es seguro llamarlo desde varios hilos.
+     * Los parametros no deben modificarse despues del primer uso.
+     */
+    const CurveCache& cache() const;
+    
     /**
      * @brief Valida los parametros de la curva
      * @return true si los parametros son validos
@@ -78,6 +161,31 @@ struct CurveParams {
      * @brief Imprime los parametros de la curva
      */
     void print() const;
+    
+private:
+    mutable std::shared_ptr<const CurveCache> cache_;
+};
+
+/**
+ * @brief Fija el modulo de ZZ_p al primo de la curva mientras existe
+ * 
+ * Restaura el ZZ_pContext precalculado en CurveParams::cache() en lugar
+ * de llamar a ZZ_p::init (que recalcula los datos del modulo cada vez) y
+ * al destruirse devuelve el modulo que hubiera antes. El modulo de NTL es
+ * local a cada hilo, asi que varios hilos pueden operar a la vez sobre
+ * curvas distintas.
+ * 
+ * Uso: CurveFieldScope scope(curve); ... aritmetica ZZ_p ...
+ */
+class CurveFieldScope {
+public:
+    explicit CurveFieldScope(const CurveParams& curve);
+    
+    CurveFieldScope(const CurveFieldScope&) = delete;
+    CurveFieldScope& operator=(const CurveFieldScope&) = delete;
+    
+private:
+    ZZ_pPush push_;
 };
 
 /**
@@ -115,6 +223,9 @@ private:
     // Referencia a la curva (no la poseemos)
     const CurveParams* curve_;
     
+    struct TrustedTag {};
+    ECPoint(const BigInt& x, const BigInt& y, const CurveParams* curve, TrustedTag);
+    
 public:
     /**
      * @brief Constructor para el punto en el infinito
@@ -122,13 +233,31 @@ public:
     ECPoint(const CurveParams* curve);
     
     /**
-     * @brief Constructor con coordenadas afines
+     * @brief Constructor con coordenadas afines, validado
+     * 
+     * Frontera de confianza: comprueba x, y en [0, p) e y^2 = x^3 + ax + b.
+     * Usar para todo punto que venga de fuera (claves publicas recibidas,
+     * puntos decodificados, ...).
+     * 
      * @param x Coordenada x
      * @param y Coordenada y
      * @param curve Parametros de la curva
+     * @throws std::invalid_argument si el punto no esta en la curva
      */
     ECPoint(const BigInt& x, const BigInt& y, const CurveParams* curve);
     
+    /**
+     * @brief Punto producido internamente, sin validar
+     * 
+     * Para resultados de la aritmetica de la propia biblioteca (ec_add,
+     * ec_double, to_affine, ...) y para G, que ya estan en la curva por
+     * construccion: ahorra el CurveFieldScope y las dos potencias de
+     * is_on_curve() en cada punto intermedio. Un punto falso aqui rompe
+     * la seguridad de quien lo use; la entrada externa va por el
+     * constructor validado.
+     */
+    static ECPoint trusted(const BigInt& x, const BigInt& y, const CurveParams* curve);
+    
     // Getters
     const BigInt& x() const { return x_; }
     const BigInt& y() const { return y_; }
@@ -271,6 +400,15 @@ JacobianPoint to_jacobian(const ECPoint& P);
  
 /** @brief Convierte Jacobiano a afin: (X, Y, Z) -> (X/Z^2, Y/Z^3) */
 ECPoint to_affine(const JacobianPoint& J);
+
+/**
+ * @brief to_affine de muchos puntos con una sola inversion (truco de Montgomery)
+ * 
+ * Coste: 1I + 3(n-1)M (+ 3M + 1S por punto), frente a n inversiones.
+ * Todos los puntos deben ser de la misma curva; los infinitos se conservan.
+ * @throws std::invalid_argument si hay puntos de curvas distintas
+ */
+std::vector<ECPoint> to_affine_batch(const std::vector<JacobianPoint>& points);
  
 /** @brief Suma en Jacobianas. Coste: 12M + 4S, 0 inversiones */
 JacobianPoint jacobian_add(const JacobianPoint& P, const JacobianPoint& Q);
@@ -278,9 +416,152 @@ JacobianPoint jacobian_add(const JacobianPoint& P, const JacobianPoint& Q);
 /** @brief Doblado en Jacobianas. Coste: 4M + 4S, 0 inversiones */
 JacobianPoint jacobian_double(const JacobianPoint& P);
  
-/** @brief Multiplicacion escalar via Jacobianas (convierte al final) */
+/**
+ * @brief Multiplicacion escalar via Jacobianas (convierte al final)
+ * 
+ * Usa el backend de campo indicado en P.curve()->backend y mantiene las
+ * coordenadas en la representacion del campo (ver ecc_native.hpp).
+ * El algoritmo lo elige P.curve()->scalar_method (o GLV, ver
+ * ec_scalar_mult_glv).
+ */
 ECPoint ec_scalar_mult_jacobian(const BigInt& k, const ECPoint& P);
 
+/**
+ * @brief Multiplicacion escalar wNAF (izquierda a derecha) en Jacobianas
+ * 
+ * Recodifica k en NAF de ventana w (digitos impares en
+ * (-2^(w-1), 2^(w-1)), con al menos w-1 ceros entre dos no nulos) y
+ * precalcula P, 3P, ..., (2^(w-1)-1)P. Para k de 256 bits y w = 4:
+ * ~256 doblados + ~51 sumas (frente a ~128 sumas de double-and-add).
+ * 
+ * @param w Ancho de ventana, 2 <= w <= 7 (tabla de 2^(w-2) puntos)
+ * @throws std::invalid_argument si w esta fuera de rango
+ */
+ECPoint ec_scalar_mult_wnaf(const BigInt& k, const ECPoint& P, int w = 4);
+
+/**
+ * @brief k*P con la escalera de Montgomery co-Z (ejecucion regular)
+ * 
+ * ec_scalar_mult y ec_scalar_mult_jacobian saltan segun los bits de k, y
+ * su tiempo filtra la clave privada en ECDH. La escalera hace siempre
+ * bits(n) vueltas (con k' = k + n o k + 2n) de ZADDC + ZADDU, 11M + 5S
+ * cada una (las 3 ultimas con formulas completas, que admiten los
+ * intermedios en el infinito), y los bits solo seleccionan un
+ * intercambio con mascara.
+ * Se activa para ECDH, claves y firma con scalar_method = LADDER.
+ * 
+ * Con FieldBackend::NTL la aritmetica de campo sigue sin ser de tiempo
+ * constante; la escalera es regular a nivel de operaciones de grupo.
+ */
+ECPoint ec_scalar_mult_ladder(const BigInt& k, const ECPoint& P);
+
+/**
+ * @brief k*P con las formulas completas de Renes-Costello-Batina
+ * 
+ * jacobian_add tiene casos especiales (H == 0, R == 0, infinito) que
+ * obligan a saltar; las formulas completas en proyectivas homogeneas
+ * valen para cualquier par de puntos (la curva debe tener orden primo).
+ * Ventana fija de 4 bits con seleccion sin saltos en la tabla: para
+ * 256 bits, 256 doblados + 64 sumas completas. Sin inversion hasta el
+ * final y sin ramas que dependan de k o de los puntos.
+ */
+ECPoint ec_scalar_mult_complete(const BigInt& k, const ECPoint& P);
+
+/**
+ * @brief k*G con la tabla de base fija del generador (solo sumas)
+ * 
+ * La tabla (ventanas de 5 bits con signo, puntos con Z = 1) se construye
+ * en el primer uso para cada backend y se guarda en curve.cache(), asi
+ * que las llamadas siguientes no repiten doblados ni comprueban G.
+ * Coste para 256 bits: ~52 sumas frente a ~256 doblados + ~128 sumas.
+ * Con scalar_method = LADDER o COMPLETE usa ese metodo regular sobre G.
+ */
+ECPoint ec_generator_mult(const BigInt& k, const CurveParams& curve);
+
+/**
+ * @brief a*P + b*Q con una sola cadena de doblados (Strauss-Shamir)
+ * 
+ * wNAF entrelazado de ancho w para ambos escalares; el resultado se
+ * mantiene en Jacobianas hasta el final (una inversion).
+ * Coste para 256 bits, w = 4: ~256 doblados + ~102 sumas, frente a
+ * ~512 doblados + ~256 sumas + 3 inversiones de dos multiplicaciones
+ * separadas mas ec_add.
+ */
+ECPoint ec_double_scalar_mult(const BigInt& a, const ECPoint& P,
+                              const BigInt& b, const ECPoint& Q, int w = 4);
+
+/**
+ * @brief u1*G + u2*Q (la combinacion de la verificacion ECDSA)
+ * 
+ * Igual que ec_double_scalar_mult, pero G usa una tabla de multiplos
+ * impares de ancho 7 cacheada en la curva (~u1/8 sumas) y Q el ancho
+ * Q.curve()->wnaf_width.
+ */
+ECPoint ec_generator_mult_add(const BigInt& u1, const BigInt& u2, const ECPoint& Q);
+
+/**
+ * @brief Metricas de la cache de tablas por clave publica
+ */
+struct KeyCacheStats {
+    uint64_t hits = 0;          // Usos servidos con la tabla de la clave
+    uint64_t misses = 0;        // Usos sin tabla (clave fria o nueva)
+    uint64_t builds = 0;        // Tablas construidas
+    uint64_t evictions = 0;     // Entradas expulsadas por el limite de memoria
+    size_t entries = 0;         // Claves seguidas ahora
+    size_t tables = 0;          // Claves con tabla ahora
+    size_t bytes = 0;           // Memoria estimada ahora
+};
+
+/**
+ * @brief Estado de la cache de claves de la curva (todos los backends)
+ * 
+ * Con CurveParams::key_cache_bytes > 0, ecdh_shared_secret(_batch) y
+ * ec_generator_mult_add (la verificacion ECDSA en Jacobianas) buscan Q en
+ * una cache LRU por codificacion SEC1 sin comprimir. Cuando una clave se
+ * ha usado KEY_CACHE_HOT_USES veces se construye su tabla de base fija,
+ * y desde ahi d*Q o u2*Q cuesta lo mismo que un k*G: ~bits/5 sumas y
+ * ningun doblado. ECDH no usa la cache con LADDER o COMPLETE (el acceso a
+ * la tabla depende de los digitos de la clave privada).
+ */
+KeyCacheStats ec_key_cache_stats(const CurveParams& curve);
+
+/**
+ * @brief Vacia la cache de claves de la curva y pone a cero sus metricas
+ */
+void ec_key_cache_clear(const CurveParams& curve);
+
+// Usos de una clave a partir de los que se construye su tabla
+constexpr uint32_t KEY_CACHE_HOT_USES = 4;
+
+/**
+ * @brief k*P por el endomorfismo GLV (solo curvas con endomorfismo: secp256k1)
+ * 
+ * k = k1 + k2*lambda (mod n) con |k1|, |k2| ~ 128 bits, y
+ * k*P = k1*P + k2*phi(P) con phi(x, y) = (beta*x, y): una cadena de ~128
+ * doblados compartida por dos wNAF de ancho P.curve()->wnaf_width.
+ * ec_scalar_mult_jacobian lo usa automaticamente si use_endomorphism.
+ * 
+ * @throws std::invalid_argument si la curva no tiene endomorfismo
+ */
+ECPoint ec_scalar_mult_glv(const BigInt& k, const ECPoint& P);
+
+/**
+ * @brief sum k_i * P_i (multiplicacion multiescalar)
+ * 
+ * Una sola cadena de doblados para todos los terminos en lugar de n
+ * multiplicaciones y n-1 sumas. Para n pequeno Straus (wNAF entrelazado,
+ * ~bits/6 sumas por termino); para n grande Pippenger (cubos, ~bits/c
+ * sumas por termino con c ~ log2(n)). En secp256k1 cada termino se parte
+ * antes con GLV. Los puntos en el infinito y los escalares 0 mod n se
+ * ignoran.
+ * 
+ * @throws std::invalid_argument si los tamanos no coinciden, estan vacios
+ *         o los puntos son de curvas distintas
+ */
+ECPoint ec_multi_scalar_mult(const std::vector<BigInt>& scalars,
+                             const std::vector<ECPoint>& points,
+                             MultiScalarMethod method = MultiScalarMethod::AUTO);
+
 // ============================================================================
 // CLAVES ECC
 // ============================================================================
@@ -313,6 +594,16 @@ struct ECKeyPair {
  */
 ECKeyPair generate_keypair(const CurveParams& curve, RNG& rng, bool use_jacobian = false);
 
+/**
+ * @brief Genera count pares de claves de una vez
+ * 
+ * Cada Q = d*G se calcula con la tabla de base fija en Jacobianas y todas
+ * las claves publicas se pasan a afin con una sola inversion
+ * (to_affine_batch) en lugar de una por clave.
+ */
+std::vector<ECKeyPair> generate_keypair_batch(const CurveParams& curve, RNG& rng,
+                                              size_t count);
+
 // ============================================================================
 // DIFFIE-HELLMAN EN CURVAS ELIPTICAS (ECDH)
 // ============================================================================
@@ -334,6 +625,17 @@ ECPoint ecdh_shared_secret(const BigInt& private_key,
                            const ECPoint& public_key,
                            bool use_jacobian = false);
 
+/**
+ * @brief ECDH para muchos pares (private_keys[i], public_keys[i])
+ * 
+ * Multiplicaciones en Jacobianas con el metodo de la curva y una sola
+ * inversion para todos los resultados.
+ * @throws std::invalid_argument si los vectores no tienen el mismo tamano
+ *         o las claves publicas son de curvas distintas
+ */
+std::vector<ECPoint> ecdh_shared_secret_batch(const std::vector<BigInt>& private_keys,
+                                              const std::vector<ECPoint>& public_keys);
+
 /**
  * @brief Deriva clave simetrica del secreto ECDH
  * @param shared_point Punto compartido
@@ -357,6 +659,11 @@ struct ECDSASignature {
     BigInt r;   // Componente r de la firma
     BigInt s;   // Componente s de la firma
     
+    // Identificador de recuperacion de R = k*G (lo rellena ecdsa_sign):
+    // bit 0 = paridad de y(R), bit 1 = x(R) >= n (x(R) = r + n).
+    // -1 si se desconoce; no forma parte de la firma (r, s)
+    int recovery_id = -1;
+    
     /**
      * @brief Verifica si la firma tiene formato válido
      * @param n Orden del grupo de la curva
@@ -409,6 +716,35 @@ ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
                                RNG& rng,
                                bool use_jacobian = false);
 
+/**
+ * @brief Firma ECDSA con nonce determinista (RFC 6979, HMAC-SHA256)
+ * 
+ * k se deriva con HMAC_DRBG de la clave privada y del hash, sin RNG:
+ * la misma entrada produce siempre la misma firma, y varios hilos pueden
+ * firmar a la vez sin compartir estado. La firma verifica igual que una
+ * de ecdsa_sign con RNG.
+ * 
+ * @param message Mensaje a firmar (string)
+ * @param private_key Clave privada (escalar d)
+ * @param curve Parámetros de la curva
+ * @return Firma ECDSA (r, s)
+ */
+ECDSASignature ecdsa_sign(const std::string& message,
+                          const BigInt& private_key,
+                          const CurveParams& curve,
+                          bool use_jacobian = false);
+
+/**
+ * @brief Firma un hash con nonce determinista (RFC 6979, HMAC-SHA256)
+ * 
+ * Con el hash SHA-256 del mensaje reproduce los vectores de RFC 6979
+ * (Apendice A.2) para P-256 y P-384 con SHA-256.
+ */
+ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
+                               const BigInt& private_key,
+                               const CurveParams& curve,
+                               bool use_jacobian = false);
+
 /**
  * @brief Verifica una firma ECDSA
  * 
@@ -424,7 +760,8 @@ ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
  * 
  * @param message Mensaje original
  * @param signature Firma a verificar
- * @param public_key Clave pública (punto Q)
+ * @param public_key Clave pública (punto Q); debe pertenecer a curve
+ *        (public_key.curve() == &curve), si no la firma se rechaza
  * @param curve Parámetros de la curva
  * @return true si la firma es válida
  */
@@ -443,6 +780,58 @@ bool ecdsa_verify_hash(const BigInt& hash_value,
                        const CurveParams& curve,
                        bool use_jacobian = false);
 
+/**
+ * @brief Verifica un lote de firmas ECDSA (claves posiblemente distintas)
+ * 
+ * Con R_i recuperado de (r_i, recovery_id_i), cada firma valida cumple
+ * u1_i*G + u2_i*Q_i - R_i = O. Con coeficientes aleatorios a_i de 128
+ * bits se comprueba una sola ecuacion con ec_multi_scalar_mult:
+ *   (sum a_i*u1_i)*G + sum_Q (sum a_i*u2_i)*Q - sum a_i*R_i = O
+ * (los terminos de una misma clave se agrupan y cada clave distinta se
+ * valida una vez). Si la ecuacion falla se verifica cada firma del lote
+ * por separado para localizar las invalidas; las firmas sin recovery_id
+ * se verifican siempre por separado. El resultado coincide con
+ * ecdsa_verify_hash salvo con probabilidad ~2^-128.
+ * 
+ * @param rng Fuente de los coeficientes a_i (deben ser impredecibles)
+ * @return Validez de cada firma, en el orden de entrada
+ * @throws std::invalid_argument si los tamanos no coinciden
+ */
+std::vector<bool> ecdsa_verify_batch(const std::vector<BigInt>& hashes,
+                                     const std::vector<ECDSASignature>& signatures,
+                                     const std::vector<ECPoint>& public_keys,
+                                     const CurveParams& curve,
+                                     RNG& rng);
+
+/**
+ * @brief Recupera la clave publica de una firma (r, s, recovery_id)
+ * 
+ * Q = r^-1 * (s*R - z*G), con R reconstruido de r y recovery_id (raiz
+ * cuadrada, ver ec_point_decode) y una sola cadena de doblados para
+ * u1*G + u2*R. Para una firma valida, ecdsa_verify_hash(hash, sig, Q)
+ * es true; quien reciba la firma debe comparar Q con la identidad
+ * esperada (la recuperacion por si sola no autentica nada).
+ * 
+ * @return Clave publica, o el punto en el infinito si la firma esta mal
+ *         formada, no tiene recovery_id o R no existe
+ */
+ECPoint ecdsa_recover(const BigInt& hash_value,
+                      const ECDSASignature& signature,
+                      const CurveParams& curve);
+
+/**
+ * @brief ecdsa_recover para muchas firmas de la misma curva
+ * 
+ * Los r^-1 mod n comparten una inversion modular y las claves pasan a
+ * afin con una sola inversion de campo.
+ * 
+ * @return Una clave por firma, en el orden de entrada (infinito si falla)
+ * @throws std::invalid_argument si los tamanos no coinciden
+ */
+std::vector<ECPoint> ecdsa_recover_batch(const std::vector<BigInt>& hashes,
+                                         const std::vector<ECDSASignature>& signatures,
+                                         const CurveParams& curve);
+
 /**
  * @brief Trunca un hash al tamaño del orden de la curva
  * 
@@ -455,6 +844,58 @@ bool ecdsa_verify_hash(const BigInt& hash_value,
  */
 BigInt truncate_hash(const BigInt& hash, const BigInt& n);
 
+// ============================================================================
+// CODIFICACION DE PUNTOS (SEC1)
+// ============================================================================
+
+/**
+ * @brief Raiz cuadrada modulo el primo de la curva
+ * 
+ * Con p = 3 (mod 4) (P-256, P-384, secp256k1) es una sola potencia
+ * a^((p+1)/4) en el backend de la curva (limbs fijos con -f mont); si no,
+ * Tonelli-Shanks.
+ * 
+ * @param a Valor en [0, p)
+ * @param root Raiz (la otra es p - root)
+ * @return false si a no es un residuo cuadratico
+ */
+bool ec_field_sqrt(const BigInt& a, const CurveParams& curve, BigInt& root);
+
+/**
+ * @brief Codifica un punto segun SEC 1 v2, Seccion 2.3.3
+ * 
+ * Con L = ceil(bits(p) / 8):
+ * - comprimido:    0x02 | paridad(y), x          (1 + L bytes; 33 en P-256)
+ * - sin comprimir: 0x04, x, y                    (1 + 2L bytes)
+ * - infinito:      0x00
+ * Las coordenadas van en big-endian con L bytes exactos.
+ */
+std::vector<uint8_t> ec_point_encode(const ECPoint& P, bool compressed = true);
+
+/**
+ * @brief Decodifica un punto SEC1 (Seccion 2.3.4) y lo valida
+ * 
+ * Comprimido: y = sqrt(x^3 + ax + b) con la paridad del prefijo (si la
+ * raiz existe el punto esta en la curva por construccion). Sin comprimir:
+ * constructor validado de ECPoint. No acepta la forma hibrida (0x06/0x07).
+ * 
+ * @throws std::invalid_argument si la longitud, el prefijo o las
+ *         coordenadas no son validos o el punto no esta en la curva
+ */
+ECPoint ec_point_decode(const std::vector<uint8_t>& data, const CurveParams& curve);
+
+/**
+ * @brief Decodifica muchos puntos de la misma curva
+ * 
+ * Las raices se calculan en la representacion nativa del backend sin
+ * salir a BigInt entre pasos y con una sola seleccion de backend. Cada
+ * punto comprimido sigue costando una exponenciacion (~bits(p) cuadrados).
+ * 
+ * @throws std::invalid_argument con el indice de la primera entrada invalida
+ */
+std::vector<ECPoint> ec_point_decode_batch(const std::vector<std::vector<uint8_t>>& data,
+                                           const CurveParams& curve);
+
 // ============================================================================
 // UTILIDADES
 // ============================================================================
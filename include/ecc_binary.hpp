@@ -14,7 +14,9 @@
 #include <NTL/GF2X.h>
 #include <NTL/GF2E.h>
 #include <NTL/GF2XFactoring.h>
+#include <cstdint>
 #include <string>
+#include <memory>
 #include <vector>
 
 namespace crypto {
@@ -83,6 +85,11 @@ enum class BinaryCurveType {
     CUSTOM_BINARY   // Definida por usuario
 };
 
+/**
+ * @brief Coeficientes y generador de una curva binaria ya convertidos a GF2E
+ */
+struct BinaryCurveCache;
+
 /**
  * @brief Parametros de una curva eliptica sobre GF(2^m)
  * 
@@ -111,11 +118,36 @@ struct BinaryCurveParams {
     std::string name;           // Nombre de la curva
     int security_bits;          // Bits de seguridad equivalentes
     
+    // Usar el endomorfismo de Frobenius (tauNAF) si la curva es de Koblitz:
+    // sustituye al double-and-add en binary_ec_scalar_mult_ld, y por tanto
+    // en claves y ECDH con use_ld, cuando P esta en el subgrupo de orden n
+    // (se comprueba; los puntos con componente de cofactor no lo usan)
+    bool use_frobenius = true;
+    
     BinaryCurveParams() : m(0), security_bits(0) {}
     
     /**
-     * @brief Inicializa el campo GF(2^m) de NTL con el polinomio reductor
+     * @brief a, b, Gx, Gy como elementos de GF(2^m)
+     * 
+     * Se convierten desde las cadenas hex una sola vez, en el primer uso,
+     * y se comparten entre copias de BinaryCurveParams. Es seguro llamarlo
+     * desde varios hilos. Los valores solo tienen sentido con el campo de
+     * esta curva activo (init_field()), y los parametros no deben
+     * modificarse despues del primer uso.
+     */
+    const BinaryCurveCache& cache() const;
+    
+    /**
+     * @brief Activa el campo GF(2^m) de la curva en el hilo actual
      * Debe llamarse antes de cualquier operacion aritmetica
+     * 
+     * GF2E::init recalcula los datos del modulo en cada llamada; aqui solo
+     * se hace una vez, en cache(), y despues se restaura el GF2EContext
+     * guardado, y solo si el campo activo en este hilo es de otra curva.
+     * El modulo de NTL es local a cada hilo, asi que varios hilos pueden
+     * operar a la vez sobre curvas distintas. Quien cambie el modulo por
+     * su cuenta (GF2E::init, GF2EPush) no debe mezclarlo con estas
+     * funciones en el mismo hilo.
      */
     void init_field() const;
     
@@ -130,6 +162,28 @@ struct BinaryCurveParams {
     bool validate() const;
     
     void print() const;
+    
+private:
+    mutable std::shared_ptr<const BinaryCurveCache> cache_;
+};
+
+struct BinaryCurveCache {
+    GF2EContext field;          // Modulo de GF(2^m) ya inicializado
+    uint64_t field_id;          // Identificador unico de field (para init_field)
+    
+    GF2E a;                     // Coeficiente a
+    GF2E b;                     // Coeficiente b
+    GF2E Gx;                    // Coordenada x del generador
+    GF2E Gy;                    // Coordenada y del generador
+    
+    // Curva de Koblitz (a en {0, 1}, b = 1, n = N(delta)): tau^2 = mu*tau - 2
+    // y delta = (tau^m - 1)/(tau - 1) = d0 + d1*tau en Z[tau]
+    bool koblitz = false;
+    int mu = 0;
+    BigInt d0;
+    BigInt d1;
+    
+    explicit BinaryCurveCache(const BinaryCurveParams& curve);
 };
 
 /**
@@ -188,6 +242,58 @@ public:
     void print() const;
 };
 
+// ============================================================================
+// PUNTO EN COORDENADAS LOPEZ-DAHAB
+// ============================================================================
+
+/**
+ * @brief Punto en coordenadas proyectivas de Lopez-Dahab (X, Y, Z)
+ * 
+ * (X : Y : Z) con Z != 0 representa el punto afin (X/Z, Y/Z^2); Z = 0 es
+ * el punto en el infinito. La ecuacion de la curva queda:
+ *   Y^2 + XYZ = X^3 Z + a X^2 Z^2 + b Z^4
+ * 
+ * Es el equivalente binario de JacobianPoint: las divisiones de la ley de
+ * grupo afin se acumulan en Z y solo se invierte una vez, al volver a
+ * afines. En GF(2^m) el cuadrado es casi gratis (lineal), asi que las
+ * formulas cambian multiplicaciones por cuadrados siempre que pueden.
+ * 
+ * Coste por operacion (M = multiplicacion, S = cuadrado, I = inversion),
+ * con a en {0, 1} como en todas las curvas SEC 2:
+ * 
+ *   Operacion              | Afin          | Lopez-Dahab
+ *   -----------------------+---------------+------------
+ *   Doblado                | 1I + 2M + 2S  | 4M + 5S
+ *   Suma mixta (LD + afin) | 1I + 2M + 1S  | 8M + 5S
+ *   Scalar mult m bits     | ~1.5m I       | 1 I (al final)
+ * 
+ * Con I ~ 10-20 M en GF(2^m) la ganancia es menor que en Fp, pero sigue
+ * siendo la mayor parte del coste de la multiplicacion escalar.
+ */
+class BinaryLDPoint {
+private:
+    GF2E X_;
+    GF2E Y_;
+    GF2E Z_;
+    const BinaryCurveParams* curve_;
+    
+public:
+    /** @brief Constructor para el punto en el infinito (Z = 0) */
+    BinaryLDPoint(const BinaryCurveParams* curve);
+    
+    /** @brief Constructor con coordenadas Lopez-Dahab */
+    BinaryLDPoint(const GF2E& X, const GF2E& Y, const GF2E& Z,
+                  const BinaryCurveParams* curve);
+    
+    const GF2E& X() const { return X_; }
+    const GF2E& Y() const { return Y_; }
+    const GF2E& Z() const { return Z_; }
+    bool is_infinity() const { return IsZero(Z_); }
+    const BinaryCurveParams* curve() const { return curve_; }
+    
+    void print() const;
+};
+
 // ============================================================================
 // OPERACIONES EN CURVA BINARIA
 // ============================================================================
@@ -231,6 +337,98 @@ BinaryECPoint binary_ec_negate(const BinaryECPoint& P);
 BinaryECPoint binary_ec_scalar_mult(const BigInt& k, const BinaryECPoint& P,
                                     const BigInt& order);
 
+// ============================================================================
+// OPERACIONES EN COORDENADAS LOPEZ-DAHAB
+// ============================================================================
+
+/** @brief Convierte punto afin a Lopez-Dahab: (x, y) -> (x, y, 1) */
+BinaryLDPoint binary_to_ld(const BinaryECPoint& P);
+
+/** @brief Convierte Lopez-Dahab a afin: (X, Y, Z) -> (X/Z, Y/Z^2) */
+BinaryECPoint binary_to_affine(const BinaryLDPoint& P);
+
+/** @brief Doblado en Lopez-Dahab. Coste: 4M + 5S, 0 inversiones */
+BinaryLDPoint binary_ld_double(const BinaryLDPoint& P);
+
+/**
+ * @brief Suma mixta P + Q con P en Lopez-Dahab y Q afin
+ * 
+ * Coste: 8M + 5S, 0 inversiones. Es la unica suma que necesita la
+ * multiplicacion escalar, porque el sumando (el punto base) es afin.
+ */
+BinaryLDPoint binary_ld_add_mixed(const BinaryLDPoint& P, const BinaryECPoint& Q);
+
+/**
+ * @brief Multiplicacion escalar via Lopez-Dahab (convierte al final)
+ * 
+ * Double-and-add de izquierda a derecha con doblados LD y sumas mixtas
+ * con P: una sola inversion en toda la operacion. En curvas de Koblitz,
+ * con use_frobenius y order = n, usa binary_ec_scalar_mult_tnaf si P
+ * esta en el subgrupo de orden n, requisito del tauNAF. Se comprueba con
+ * una prueba de trazas (~2m cuadrados): un punto con componente de
+ * cofactor (p.ej. una clave publica ajena sin validar) sigue por
+ * double-and-add y da el mismo resultado que binary_ec_scalar_mult.
+ */
+BinaryECPoint binary_ec_scalar_mult_ld(const BigInt& k, const BinaryECPoint& P,
+                                       const BigInt& order);
+
+/**
+ * @brief k*P con tauNAF de ventana w en una curva de Koblitz
+ * 
+ * En las curvas de Koblitz (sect163k1, sect233k1, sect283k1) el mapa de
+ * Frobenius tau(x, y) = (x^2, y^2) cumple tau^2 = mu*tau - 2 sobre los
+ * puntos, asi que un escalar de Z[tau] se aplica con cuadrados en lugar
+ * de doblados:
+ *   1. k se reduce modulo delta = (tau^m - 1)/(tau - 1), que anula el
+ *      subgrupo de orden n: rho = r0 + r1*tau, con r0, r1 de ~m/2 bits
+ *   2. rho se recodifica en tauNAF de ventana w (digitos impares en
+ *      (-2^(w-1), 2^(w-1)) que representan alpha_u = u mod tau^w)
+ *   3. Horner en tau: ~m Frobenius en Lopez-Dahab (3S cada uno) y
+ *      ~m/(w+1) sumas mixtas con la tabla alpha_u*P, ya en afines
+ * Comparado con double-and-add, los m doblados desaparecen.
+ * 
+ * P debe estar en el subgrupo de orden n (las claves generadas lo estan).
+ * 
+ * @param w Ancho de ventana, 2 <= w <= 7 (tabla de 2^(w-2) puntos)
+ * @throws std::invalid_argument si la curva no es de Koblitz o w esta
+ *         fuera de rango
+ */
+BinaryECPoint binary_ec_scalar_mult_tnaf(const BigInt& k, const BinaryECPoint& P,
+                                         const BigInt& order, int w = 5);
+
+/**
+ * @brief Coordenada x de k*P con la escalera de Montgomery de Lopez-Dahab
+ * 
+ * En y^2 + xy = x^3 + ax^2 + b, x(P1 + P2) se puede calcular a partir de
+ * x(P1), x(P2) y x(P2 - P1) sin usar y. La escalera mantiene
+ * R1 = j*P y R2 = (j+1)*P solo como (X : Z), x = X/Z:
+ *   doblado:  X' = X^4 + b*Z^4,  Z' = X^2 * Z^2
+ *   suma:     Z' = (X1*Z2 + X2*Z1)^2,  X' = x*Z' + (X1*Z2)*(X2*Z1)
+ * 6M + 5S por bit (5M + 5S con b = 1) y una sola inversion al final.
+ * 
+ * Hace siempre bits(order*h) vueltas (con k' = k + order*h o
+ * k + 2*order*h, que anulan cualquier punto de la curva si order = n)
+ * y los bits solo entran como mascara de un intercambio condicional sin
+ * saltos (XOR sobre las palabras de GF2X): regular a nivel de operaciones
+ * de campo, aunque la aritmetica GF2E de NTL en si no es de tiempo
+ * constante.
+ * 
+ * @param x Salida: x(k*P) si el resultado no es el infinito
+ * @return false si k*P = O
+ */
+bool binary_ec_ladder_x(const BigInt& k, const BinaryECPoint& P,
+                        const BigInt& order, GF2E& x);
+
+/**
+ * @brief k*P completo con la escalera de Lopez-Dahab
+ * 
+ * Misma escalera que binary_ec_ladder_x; y se recupera al final a partir
+ * de (X1 : Z1) = k*P, (X2 : Z2) = (k+1)*P y P, con la misma inversion:
+ *   y3 = (x + x3) * [(X1 + x*Z1)(X2 + x*Z2) + (x^2 + y)*Z1*Z2] / (x*Z1*Z2) + y
+ */
+BinaryECPoint binary_ec_scalar_mult_ladder(const BigInt& k, const BinaryECPoint& P,
+                                           const BigInt& order);
+
 // ============================================================================
 // CLAVES Y OPERACIONES CRIPTOGRAFICAS EN CURVAS BINARIAS
 // ============================================================================
@@ -244,15 +442,30 @@ struct BinaryECKeyPair {
 
 /**
  * @brief Genera par de claves para curva binaria
+ * @param use_ld Usar coordenadas Lopez-Dahab en la multiplicacion escalar
  */
-BinaryECKeyPair binary_generate_keypair(const BinaryCurveParams& curve, RNG& rng);
+BinaryECKeyPair binary_generate_keypair(const BinaryCurveParams& curve, RNG& rng,
+                                        bool use_ld = false);
 
 /**
  * @brief ECDH sobre curva binaria
+ * @param use_ld Usar coordenadas Lopez-Dahab en la multiplicacion escalar
  */
 BinaryECPoint binary_ecdh_shared_secret(const BigInt& private_key,
                                         const BinaryECPoint& public_key,
-                                        const BigInt& order);
+                                        const BigInt& order,
+                                        bool use_ld = false);
+
+/**
+ * @brief ECDH sobre curva binaria devolviendo solo x(d*Q)
+ * 
+ * La clave compartida solo usa la coordenada x, asi que se calcula con
+ * binary_ec_ladder_x, sin recuperar y.
+ * @throws std::runtime_error si d*Q es el punto en el infinito
+ */
+GF2E binary_ecdh_shared_x(const BigInt& private_key,
+                          const BinaryECPoint& public_key,
+                          const BigInt& order);
 
 // ============================================================================
 // UTILIDADES
@@ -0,0 +1,532 @@
+// ecc_field.hpp
+// Aritmetica de campo primo Fp con limbs de tamano fijo (Montgomery generico
+// o reduccion rapida de Solinas para P-256, P-384 y secp256k1)
+// Backend alternativo a NTL::ZZ_p para las curvas sobre campos primos
+//
+// Autor: Leon Elliott Fuller
+// Fecha: 2026-10-16
+
+#ifndef ECC_FIELD_HPP
+#define ECC_FIELD_HPP
+
+#include "common.hpp"
+#include <NTL/ZZ.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace crypto {
+
+using namespace NTL;
+
+// ============================================================================
+// ELEMENTO DE CAMPO DE TAMANO FIJO
+// ============================================================================
+
+/**
+ * Por que un segundo backend de campo
+ *
+ * NTL::ZZ_p es generico: cada elemento es un entero de precision arbitraria
+ * en el heap, y cada operacion de grupo (ec_add, jacobian_add, ...) convierte
+ * BigInt -> ZZ_p -> BigInt. Para P-256 esto significa reservar y liberar
+ * memoria decenas de veces por suma de puntos.
+ *
+ * Aqui el elemento es un array de N palabras de 64 bits en la pila:
+ * - N = 4 para p <= 256 bits (P-256, secp256k1)
+ * - N = 6 para p <= 384 bits (P-384)
+ *
+ * Los elementos se guardan en forma de Montgomery: a~ = a * R mod p, con
+ * R = 2^(64N). La multiplicacion de Montgomery calcula a~ * b~ * R^(-1),
+ * que vuelve a estar en forma de Montgomery, y la reduccion solo necesita
+ * multiplicaciones por palabra y desplazamientos (sin divisiones).
+ *
+ * Todos los elementos se mantienen totalmente reducidos en [0, p), por lo
+ * que la igualdad es comparacion directa de limbs.
+ */
+template<size_t N>
+struct FpElem {
+    uint64_t v[N];      // Limbs en little-endian (v[0] = palabra menos significativa)
+};
+
+/**
+ * @brief Metodo de reduccion modular del campo
+ * 
+ * Los primos de las curvas estandar son "generalized Mersenne" (Solinas):
+ * 2^256 mod p se escribe con pocas potencias de 2, asi que el producto de
+ * 512 bits se reduce con sumas y restas de palabras de 32/64 bits en lugar
+ * de la reduccion generica de Montgomery. Se elige automaticamente al
+ * construir el campo comparando p con los primos conocidos.
+ * 
+ * Con reduccion especial los elementos se guardan en forma normal (no
+ * Montgomery); la API de FpField es identica en ambos casos.
+ */
+enum class FpReduction {
+    MONTGOMERY,     // Generica, cualquier p impar
+    NIST_P256,      // p = 2^256 - 2^224 + 2^192 + 2^96 - 1   (FIPS 186-4, D.2.3)
+    NIST_P384,      // p = 2^384 - 2^128 - 2^96 + 2^32 - 1    (FIPS 186-4, D.2.4)
+    SECP256K1       // p = 2^256 - 2^32 - 977                 (SEC 2, 2.4.1)
+};
+
+/**
+ * @brief Campo primo Fp con elementos de N limbs
+ *
+ * Contiene las constantes precalculadas del modulo (p, -p^(-1) mod 2^64,
+ * R^2 mod p) y el metodo de reduccion (ver FpReduction). Se construye una vez por curva y despues todas las
+ * operaciones son funciones const sin reserva de memoria.
+ *
+ * Coste relativo (P-256, N = 4): mul ~ 16 productos 64x64 + reduccion,
+ * add/sub ~ 8 sumas con acarreo, inv ~ 256 sqr + 64 mul (Fermat).
+ */
+template<size_t N>
+class FpField {
+public:
+    using Elem = FpElem<N>;
+    static constexpr size_t LIMBS = N;
+
+    /**
+     * @brief Construye el campo para el primo p
+     * @param p Primo impar que cabe en N limbs
+     * @param allow_special Usar reduccion rapida si p es un primo conocido
+     *        (false fuerza Montgomery generico, util para comparar)
+     * @throws std::invalid_argument si p es par o no cabe en N limbs
+     */
+    explicit FpField(const BigInt& p, bool allow_special = true);
+
+    // Aritmetica (resultado totalmente reducido en [0, p))
+    Elem add(const Elem& a, const Elem& b) const;
+    Elem sub(const Elem& a, const Elem& b) const;
+    Elem neg(const Elem& a) const { return sub(zero_, a); }
+    Elem dbl(const Elem& a) const { return add(a, a); }
+    Elem mul(const Elem& a, const Elem& b) const;
+    Elem sqr(const Elem& a) const { return mul(a, a); }
+
+    /** @brief Inversion por Fermat: a^(p-2). inv(0) = 0 */
+    Elem inv(const Elem& a) const;
+
+    /**
+     * @brief Raiz cuadrada: false si a no es un cuadrado
+     *
+     * p = 3 (mod 4) (P-256, P-384, secp256k1): root = a^((p+1)/4), una
+     * exponenciacion como inv() mas una comprobacion. Otros p: Tonelli-
+     * Shanks de NTL sobre BigInt.
+     */
+    bool sqrt(const Elem& a, Elem& root) const;
+
+    /** @brief Intercambia a y b si bit = 1, sin saltos (mascara) */
+    void cswap(Elem& a, Elem& b, uint64_t bit) const;
+
+    bool is_zero(const Elem& a) const;
+    bool equal(const Elem& a, const Elem& b) const;
+
+    // Conversion en la frontera con BigInt (entra/sale de la representacion interna)
+    Elem from_bigint(const BigInt& x) const;
+    BigInt to_bigint(const Elem& a) const;
+
+    const Elem& zero() const { return zero_; }
+    const Elem& one() const { return one_; }
+    const BigInt& modulus() const { return p_big_; }
+    FpReduction reduction() const { return reduction_; }
+
+private:
+    FpReduction reduction_;
+    Elem p_;            // Modulo p
+    uint64_t n0_;       // -p^(-1) mod 2^64
+    Elem r2_;           // R^2 mod p (para entrar en forma de Montgomery)
+    Elem zero_;
+    Elem one_;          // R mod p en Montgomery, 1 con reduccion especial
+    BigInt p_big_;
+    BigInt inv_exp_;    // p - 2: exponente de inv, sin BigInt temporales por llamada
+    bool sqrt_fast_;    // p = 3 (mod 4): sqrt es una sola exponenciacion
+    BigInt sqrt_exp_;   // (p + 1) / 4 si sqrt_fast_
+
+    Elem reduce_once(const uint64_t t[N], uint64_t hi) const;
+    Elem mont_mul(const Elem& a, const Elem& b) const;
+    Elem special_mul(const Elem& a, const Elem& b) const;
+
+    /** @brief a^e con ventana fija de 4 bits (e >= 0 publico) */
+    Elem pow(const Elem& a, const BigInt& e) const;
+};
+
+// ============================================================================
+// IMPLEMENTACION INLINE (camino caliente)
+// ============================================================================
+
+using u128 = unsigned __int128;
+
+/**
+ * Resta condicional de p: devuelve t - p si (hi:t) >= p, si no t.
+ * La seleccion se hace con mascara, sin saltos dependientes del valor.
+ */
+template<size_t N>
+inline FpElem<N> FpField<N>::reduce_once(const uint64_t t[N], uint64_t hi) const {
+    Elem s;
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < N; i++) {
+        u128 d = (u128)t[i] - p_.v[i] - borrow;
+        s.v[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    // Usar s si hubo acarreo alto o si la resta no pidio prestado
+    uint64_t mask = 0 - (uint64_t)((hi != 0) | (borrow == 0));
+    Elem r;
+    for (size_t i = 0; i < N; i++) {
+        r.v[i] = (s.v[i] & mask) | (t[i] & ~mask);
+    }
+    return r;
+}
+
+template<size_t N>
+inline FpElem<N> FpField<N>::add(const Elem& a, const Elem& b) const {
+    uint64_t t[N];
+    uint64_t carry = 0;
+    for (size_t i = 0; i < N; i++) {
+        u128 s = (u128)a.v[i] + b.v[i] + carry;
+        t[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+    return reduce_once(t, carry);
+}
+
+template<size_t N>
+inline FpElem<N> FpField<N>::sub(const Elem& a, const Elem& b) const {
+    Elem r;
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < N; i++) {
+        u128 d = (u128)a.v[i] - b.v[i] - borrow;
+        r.v[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    // Si hubo prestamo, sumar p (mascara en lugar de salto)
+    uint64_t mask = 0 - borrow;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < N; i++) {
+        u128 s = (u128)r.v[i] + (p_.v[i] & mask) + carry;
+        r.v[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+    return r;
+}
+
+template<size_t N>
+inline void FpField<N>::cswap(Elem& a, Elem& b, uint64_t bit) const {
+    uint64_t mask = 0 - (bit & 1);
+    for (size_t i = 0; i < N; i++) {
+        uint64_t t = (a.v[i] ^ b.v[i]) & mask;
+        a.v[i] ^= t;
+        b.v[i] ^= t;
+    }
+}
+
+/**
+ * Multiplicacion de Montgomery (CIOS, Coarsely Integrated Operand Scanning)
+ *
+ * Para cada palabra b[i]:
+ *   t = t + a * b[i]
+ *   m = t[0] * (-p^(-1)) mod 2^64     (hace t divisible por 2^64)
+ *   t = (t + m * p) / 2^64
+ *
+ * Tras N vueltas t = a * b * R^(-1) mod p, con t < 2p: basta una resta
+ * condicional. Coste: 2N^2 + N productos de 64x64 bits.
+ */
+template<size_t N>
+inline FpElem<N> FpField<N>::mont_mul(const Elem& a, const Elem& b) const {
+    uint64_t t[N + 2] = {0};
+    for (size_t i = 0; i < N; i++) {
+        u128 c = 0;
+        for (size_t j = 0; j < N; j++) {
+            c += (u128)a.v[j] * b.v[i] + t[j];
+            t[j] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[N];
+        t[N] = (uint64_t)c;
+        t[N + 1] = (uint64_t)(c >> 64);
+
+        uint64_t m = t[0] * n0_;
+        c = (u128)m * p_.v[0] + t[0];
+        c >>= 64;
+        for (size_t j = 1; j < N; j++) {
+            c += (u128)m * p_.v[j] + t[j];
+            t[j - 1] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[N];
+        t[N - 1] = (uint64_t)c;
+        t[N] = t[N + 1] + (uint64_t)(c >> 64);
+    }
+    return reduce_once(t, t[N]);
+}
+
+// ============================================================================
+// REDUCCION RAPIDA PARA PRIMOS DE SOLINAS
+// ============================================================================
+
+/**
+ * Producto completo de N x N limbs -> 2N limbs (escolar, N^2 productos)
+ */
+template<size_t N>
+inline void fp_mul_wide(const uint64_t a[N], const uint64_t b[N], uint64_t t[2 * N]) {
+    for (size_t i = 0; i < 2 * N; i++) t[i] = 0;
+    for (size_t i = 0; i < N; i++) {
+        u128 c = 0;
+        for (size_t j = 0; j < N; j++) {
+            c += (u128)a[j] * b[i] + t[i + j];
+            t[i + j] = (uint64_t)c;
+            c >>= 64;
+        }
+        t[i + N] = (uint64_t)c;
+    }
+}
+
+/**
+ * Ajuste final comun: el valor es V = r + carry * 2^(64N), con carry
+ * pequeno y con signo. Restar carry * p deja V' = r + carry * (2^(64N) - p),
+ * que cae en (-p, 2p) porque 2^(64N) - p es pequeno frente a p; una suma
+ * y una resta condicionales terminan la reduccion.
+ *
+ * Todo el camino es de tiempo constante: el signo de carry, la suma de p y
+ * la resta final se aplican con mascaras, sin saltos que dependan del valor
+ * (las curvas con nombre pasan por aqui tambien en la escalera y en la
+ * multiplicacion completa).
+ */
+template<size_t N>
+inline void fp_solinas_finish(uint64_t r[N], int64_t carry, const uint64_t p[N]) {
+    // 1. V - carry * p sobre N+1 limbs (el limb alto es carry con signo).
+    //    Con k = |carry|: si carry >= 0 se suma ~(k*p) + 1 (= -k*p), si
+    //    carry < 0 se suma k*p; la mascara m elige sin saltar.
+    uint64_t neg = (uint64_t)(carry >> 63);         // todo unos si carry < 0
+    uint64_t k = ((uint64_t)carry ^ neg) - neg;
+    uint64_t m = ~neg;
+    uint64_t mc = 0;        // acarreo de k * p
+    u128 c = m & 1;         // +1 del complemento a dos
+    for (size_t i = 0; i < N; i++) {
+        u128 kp = (u128)p[i] * k + mc;
+        mc = (uint64_t)(kp >> 64);
+        c += (u128)r[i] + ((uint64_t)kp ^ m);
+        r[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    uint64_t top = (uint64_t)carry + (mc ^ m) + (uint64_t)c;
+    
+    // 2. top es 0 o -1: si V' < 0, sumar p (mascara)
+    uint64_t mask = (uint64_t)((int64_t)top >> 63);
+    c = 0;
+    for (size_t i = 0; i < N; i++) {
+        c += (u128)r[i] + (p[i] & mask);
+        r[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    top += (uint64_t)c;
+    
+    // 3. V' en [0, 2p): restar p si (top, r) >= p, eligiendo con mascara
+    uint64_t s[N];
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < N; i++) {
+        u128 d = (u128)r[i] - p[i] - borrow;
+        s[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    borrow = (uint64_t)(((u128)top - borrow) >> 64) & 1;
+    mask = borrow - 1;      // todo unos si no hubo prestamo (V' >= p)
+    for (size_t i = 0; i < N; i++) r[i] = (s[i] & mask) | (r[i] & ~mask);
+}
+
+/**
+ * Parte el producto de 2N limbs en 4N palabras de 32 bits (con signo de
+ * 64 bits para poder acumular sumas y restas sin desbordar)
+ */
+template<size_t N>
+inline void fp_split_words(const uint64_t t[2 * N], int64_t c[4 * N]) {
+    for (size_t i = 0; i < 2 * N; i++) {
+        c[2 * i] = (uint32_t)t[i];
+        c[2 * i + 1] = (uint32_t)(t[i] >> 32);
+    }
+}
+
+/**
+ * P-256: con c0..c15 las palabras de 32 bits del producto (FIPS 186-4, D.2.3)
+ *   r = s1 + 2*s2 + 2*s3 + s4 + s5 - d1 - d2 - d3 - d4  (mod p)
+ * s1 es la mitad baja y el resto son permutaciones de la mitad alta; aqui
+ * los nueve terminos ya estan sumados palabra a palabra.
+ */
+inline void fp_reduce_p256(const uint64_t t[8], uint64_t r[4], const uint64_t p[4]) {
+    int64_t c[16];
+    fp_split_words<4>(t, c);
+    
+    int64_t acc = 0;
+    auto put = [&](int j) {
+        uint64_t w = (uint32_t)acc;
+        if (j & 1) r[j / 2] |= w << 32;
+        else r[j / 2] = w;
+        acc >>= 32;                     // desplazamiento aritmetico: conserva el signo
+    };
+    acc += c[0] + c[8] + c[9] - c[11] - c[12] - c[13] - c[14];
+    put(0);
+    acc += c[1] + c[9] + c[10] - c[12] - c[13] - c[14] - c[15];
+    put(1);
+    acc += c[2] + c[10] + c[11] - c[13] - c[14] - c[15];
+    put(2);
+    acc += c[3] + 2 * c[11] + 2 * c[12] + c[13] - c[15] - c[8] - c[9];
+    put(3);
+    acc += c[4] + 2 * c[12] + 2 * c[13] + c[14] - c[9] - c[10];
+    put(4);
+    acc += c[5] + 2 * c[13] + 2 * c[14] + c[15] - c[10] - c[11];
+    put(5);
+    acc += c[6] + 3 * c[14] + 2 * c[15] + c[13] - c[8] - c[9];
+    put(6);
+    acc += c[7] + 3 * c[15] + c[8] - c[10] - c[11] - c[12] - c[13];
+    put(7);
+    
+    fp_solinas_finish<4>(r, acc, p);
+}
+
+/**
+ * P-384: con c0..c23 las palabras de 32 bits del producto (FIPS 186-4, D.2.4)
+ *   r = s1 + 2*s2 + s3 + s4 + s5 + s6 + s7 - d1 - d2 - d3  (mod p)
+ */
+inline void fp_reduce_p384(const uint64_t t[12], uint64_t r[6], const uint64_t p[6]) {
+    int64_t c[24];
+    fp_split_words<6>(t, c);
+    
+    int64_t acc = 0;
+    auto put = [&](int j) {
+        uint64_t w = (uint32_t)acc;
+        if (j & 1) r[j / 2] |= w << 32;
+        else r[j / 2] = w;
+        acc >>= 32;
+    };
+    acc += c[0] + c[12] + c[21] + c[20] - c[23];
+    put(0);
+    acc += c[1] + c[13] + c[22] + c[23] - c[12] - c[20];
+    put(1);
+    acc += c[2] + c[14] + c[23] - c[13] - c[21];
+    put(2);
+    acc += c[3] + c[15] + c[12] + c[20] + c[21] - c[14] - c[22] - c[23];
+    put(3);
+    acc += c[4] + 2 * c[21] + c[16] + c[13] + c[12] + c[20] + c[22] - c[15] - 2 * c[23];
+    put(4);
+    acc += c[5] + 2 * c[22] + c[17] + c[14] + c[13] + c[21] + c[23] - c[16];
+    put(5);
+    acc += c[6] + 2 * c[23] + c[18] + c[15] + c[14] + c[22] - c[17];
+    put(6);
+    acc += c[7] + c[19] + c[16] + c[15] + c[23] - c[18];
+    put(7);
+    acc += c[8] + c[20] + c[17] + c[16] - c[19];
+    put(8);
+    acc += c[9] + c[21] + c[18] + c[17] - c[20];
+    put(9);
+    acc += c[10] + c[22] + c[19] + c[18] - c[21];
+    put(10);
+    acc += c[11] + c[23] + c[20] + c[19] - c[22];
+    put(11);
+    
+    fp_solinas_finish<6>(r, acc, p);
+}
+
+/**
+ * secp256k1: p = 2^256 - C con C = 2^32 + 977, asi que 2^256 = C (mod p)
+ *   t = hi * 2^256 + lo  =>  t = lo + hi * C  (mod p)
+ * Dos pliegues dejan el valor en 256 bits + un acarreo de como mucho 1,
+ * que se pliega una vez mas.
+ */
+inline void fp_reduce_secp256k1(const uint64_t t[8], uint64_t r[4], const uint64_t p[4]) {
+    const uint64_t C = 0x1000003D1ULL;
+    
+    // Primer pliegue: lo + hi * C  (< 2^256 + 2^290)
+    uint64_t s[5];
+    u128 c = 0;
+    for (int i = 0; i < 4; i++) {
+        c += (u128)t[4 + i] * C + t[i];
+        s[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    s[4] = (uint64_t)c;
+    
+    // Segundo pliegue: s[0..3] + s[4] * C
+    c = (u128)s[4] * C + s[0];
+    r[0] = (uint64_t)c;
+    c >>= 64;
+    for (int i = 1; i < 4; i++) {
+        c += s[i];
+        r[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    
+    // Acarreo final (0 o 1): otro C
+    uint64_t extra = (uint64_t)c * C;
+    c = (u128)r[0] + extra;
+    r[0] = (uint64_t)c;
+    c >>= 64;
+    for (int i = 1; i < 4; i++) {
+        c += r[i];
+        r[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    fp_solinas_finish<4>(r, 0, p);
+}
+
+template<size_t N>
+inline FpElem<N> FpField<N>::special_mul(const Elem& a, const Elem& b) const {
+    uint64_t t[2 * N];
+    fp_mul_wide<N>(a.v, b.v, t);
+    Elem r;
+    if constexpr (N == 4) {
+        if (reduction_ == FpReduction::NIST_P256) {
+            fp_reduce_p256(t, r.v, p_.v);
+        } else {
+            fp_reduce_secp256k1(t, r.v, p_.v);
+        }
+    } else if constexpr (N == 6) {
+        fp_reduce_p384(t, r.v, p_.v);
+    }
+    return r;
+}
+
+template<size_t N>
+inline FpElem<N> FpField<N>::mul(const Elem& a, const Elem& b) const {
+    if (reduction_ == FpReduction::MONTGOMERY) return mont_mul(a, b);
+    return special_mul(a, b);
+}
+
+template<size_t N>
+inline bool FpField<N>::is_zero(const Elem& a) const {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < N; i++) acc |= a.v[i];
+    return acc == 0;
+}
+
+template<size_t N>
+inline bool FpField<N>::equal(const Elem& a, const Elem& b) const {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < N; i++) acc |= a.v[i] ^ b.v[i];
+    return acc == 0;
+}
+
+// ============================================================================
+// CONTEXTO DE CAMPO POR CURVA
+// ============================================================================
+
+/**
+ * @brief Campo de tamano fijo asociado a un primo concreto
+ *
+ * Elige automaticamente el numero de limbs segun el tamano de p (y
+ * FpField elige a su vez la reduccion especial si p es un primo conocido).
+ * Si p tiene mas de 384 bits (o es par) no se construye ningun campo y
+ * available() devuelve false: el llamador debe usar el backend NTL.
+ */
+struct FpContext {
+    std::unique_ptr<FpField<4>> f4;     // p <= 256 bits
+    std::unique_ptr<FpField<6>> f6;     // 256 < p <= 384 bits
+
+    explicit FpContext(const BigInt& p);
+
+    bool available() const { return f4 || f6; }
+};
+
+// Instanciaciones explicitas en ecc_field.cpp
+extern template class FpField<4>;
+extern template class FpField<6>;
+
+} // namespace crypto
+
+#endif // ECC_FIELD_HPP
@@ -0,0 +1,1627 @@
+// ecc_native.hpp
+// Puntos Jacobianos en la representacion nativa del campo
+// Las coordenadas no pasan por BigInt durante la multiplicacion escalar
+//
+// Autor: Leon Elliott Fuller
+// Fecha: 2026-10-16
+
+#ifndef ECC_NATIVE_HPP
+#define ECC_NATIVE_HPP
+
+#include "ecc.hpp"
+#include "ecc_field.hpp"
+#include <NTL/ZZ_p.h>
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace crypto {
+
+// ============================================================================
+// ADAPTADOR NTL (ZZ_p) CON LA INTERFAZ DE FpField
+// ============================================================================
+
+/**
+ * @brief Campo Fp de NTL con la misma interfaz que FpField<N>
+ *
+ * Permite escribir los algoritmos de punto una sola vez (plantillas sobre
+ * el campo) y usarlos tanto con ZZ_p como con los limbs de tamano fijo.
+ * Mientras el objeto existe, el modulo de ZZ_p es el primo de la curva
+ * (contiene un CurveFieldScope).
+ */
+class ZZpField {
+public:
+    using Elem = ZZ_p;
+
+    explicit ZZpField(const CurveParams& curve)
+        : scope_(curve), p_(curve.p), zero_(), one_(conv<ZZ_p>(1)) {}
+
+    Elem add(const Elem& a, const Elem& b) const { return a + b; }
+    Elem sub(const Elem& a, const Elem& b) const { return a - b; }
+    Elem neg(const Elem& a) const { return -a; }
+    Elem dbl(const Elem& a) const { return a + a; }
+    Elem mul(const Elem& a, const Elem& b) const { return a * b; }
+    Elem sqr(const Elem& a) const { return NTL::sqr(a); }
+
+    /** @brief inv(0) = 0, como en FpField */
+    Elem inv(const Elem& a) const { return IsZero(a) ? a : NTL::inv(a); }
+
+    /** @brief Raiz cuadrada; p = 3 (mod 4) con una potencia, si no Tonelli-Shanks */
+    bool sqrt(const Elem& a, Elem& root) const {
+        if (p_ % 4 == 3) {
+            root = power(a, (p_ + 1) / 4);
+            return NTL::sqr(root) == a;
+        }
+        if (Jacobi(rep(a), p_) < 0) return false;
+        BigInt r;
+        SqrRootMod(r, rep(a), p_);
+        root = conv<ZZ_p>(r);
+        return true;
+    }
+
+    /** @brief Intercambio condicional (NTL no es de tiempo constante) */
+    void cswap(Elem& a, Elem& b, uint64_t bit) const { if (bit) std::swap(a, b); }
+
+    bool is_zero(const Elem& a) const { return IsZero(a); }
+    bool equal(const Elem& a, const Elem& b) const { return a == b; }
+
+    Elem from_bigint(const BigInt& x) const { return conv<ZZ_p>(x); }
+    BigInt to_bigint(const Elem& a) const { return rep(a); }
+
+    const Elem& zero() const { return zero_; }
+    const Elem& one() const { return one_; }
+    const BigInt& modulus() const { return p_; }
+
+private:
+    CurveFieldScope scope_;     // Debe construirse antes que los ZZ_p
+    BigInt p_;
+    Elem zero_;
+    Elem one_;
+};
+
+// ============================================================================
+// PUNTO JACOBIANO NATIVO
+// ============================================================================
+
+/**
+ * @brief Punto Jacobiano (X : Y : Z) con coordenadas del tipo del campo
+ *
+ * Representa el punto afin (X/Z^2, Y/Z^3); Z = 0 es el punto en el infinito.
+ * Con FpField<N> las coordenadas estan en la pila (forma de Montgomery o
+ * normal, segun el primo) y ninguna operacion de grupo reserva memoria.
+ */
+template<class Field>
+struct NativeJacobian {
+    typename Field::Elem X, Y, Z;
+};
+
+/**
+ * @brief Punto proyectivo homogeneo (X : Y : Z) = (X/Z, Y/Z)
+ *
+ * Es la representacion de las formulas completas (Renes-Costello-Batina):
+ * el infinito es (0 : 1 : 0) y la suma no tiene casos especiales.
+ */
+template<class Field>
+struct NativeProjective {
+    typename Field::Elem X, Y, Z;
+};
+
+// ============================================================================
+// PRECALCULOS POR CURVA
+// ============================================================================
+
+/**
+ * @brief Tabla de base fija (ventanas de WINDOW bits con signo)
+ *
+ * Con digitos d_i en [-2^(w-1), 2^(w-1)]:
+ *   k = sum d_i * 2^(w*i)  =>  k*B = sum d_i * (2^(w*i) * B)
+ * entry(i, j) = j * 2^(w*i) * B para j = 1..2^(w-1), normalizado (Z = 1).
+ * Una multiplicacion cuesta ~bits/w sumas y ningun doblado; para P-256
+ * son 52 sumas y 52 x 16 puntos de tabla.
+ */
+template<class Field>
+struct FixedBaseTable {
+    static constexpr int WINDOW = 5;
+    static constexpr int ROW = 1 << (WINDOW - 1);     // Entradas por ventana
+
+    long windows = 0;
+    std::vector<NativeJacobian<Field>> entries;       // windows * ROW
+
+    const NativeJacobian<Field>& entry(long i, int j) const {
+        return entries[i * ROW + (j - 1)];
+    }
+};
+
+/**
+ * @brief Valor que se construye en el primer uso y luego solo se lee
+ *
+ * std::call_once garantiza una unica construccion aunque varios hilos
+ * lo pidan a la vez; si build() lanza, el siguiente get() lo reintenta.
+ */
+template<class T>
+class LazySlot {
+public:
+    template<class Build>
+    const T& get(Build&& build) const {
+        std::call_once(once_, [&]() { value_.reset(new T(build())); });
+        return *value_;
+    }
+
+private:
+    mutable std::once_flag once_;
+    mutable std::unique_ptr<const T> value_;
+};
+
+/**
+ * @brief Forma del coeficiente a, para elegir la formula de doblado
+ *
+ * P-256 y P-384 tienen a = -3 y secp256k1 a = 0; ambos casos ahorran
+ * multiplicaciones frente a la formula generica.
+ */
+enum class CurveShape {
+    GENERIC,
+    A_ZERO,         // secp256k1
+    A_MINUS_3       // NIST P-256, P-384
+};
+
+inline CurveShape detect_curve_shape(const CurveParams& curve) {
+    BigInt a = curve.a % curve.p;
+    if (IsZero(a)) return CurveShape::A_ZERO;
+    if (a == curve.p - 3) return CurveShape::A_MINUS_3;
+    return CurveShape::GENERIC;
+}
+
+/**
+ * @brief Endomorfismo eficiente (GLV) de una curva con a = 0
+ *
+ * phi(x, y) = (beta*x, y) = lambda*(x, y), con beta^3 = 1 (mod p) y
+ * lambda^3 = 1 (mod n). Los vectores (a1, b1), (a2, b2) son una base
+ * corta del reticulo {(x, y) : x + y*lambda = 0 (mod n)} y permiten
+ * escribir k = k1 + k2*lambda (mod n) con |k1|, |k2| ~ sqrt(n).
+ */
+struct GlvParams {
+    BigInt beta;        // Raiz cubica de la unidad en Fp
+    BigInt lambda;      // Valor propio de phi en Z_n
+    BigInt a1, b1;
+    BigInt a2, b2;
+};
+
+/**
+ * @brief Constantes GLV si la curva las tiene (hoy: secp256k1), o nullptr
+ */
+std::unique_ptr<const GlvParams> glv_params_for(const CurveParams& curve);
+
+/**
+ * @brief Descompone k en [0, n) como k1 + k2*lambda (mod n), ~bits(n)/2 cada uno
+ *
+ * c1 = round(b2*k/n), c2 = round(-b1*k/n)
+ * k1 = k - c1*a1 - c2*a2,  k2 = -c1*b1 - c2*b2   (pueden ser negativos)
+ */
+void glv_split(const GlvParams& glv, const BigInt& n, const BigInt& k,
+               BigInt& k1, BigInt& k2);
+
+/**
+ * @brief Precalculos del generador G en una representacion del campo
+ */
+template<class Field>
+struct GeneratorTables {
+    // Multiplos impares de G para wNAF interleaved (ancho G_WNAF_WIDTH)
+    static constexpr int G_WNAF_WIDTH = 7;
+
+    LazySlot<FixedBaseTable<Field>> fixed;                  // k*G
+    LazySlot<std::vector<NativeJacobian<Field>>> odd;       // G, 3G, ..., 63G (Z = 1)
+};
+
+/**
+ * @brief Codificacion SEC1 sin comprimir de Q (0x04 || x || y): clave de
+ * la cache de tablas por clave publica
+ */
+std::string point_cache_key(const ECPoint& Q);
+
+/**
+ * @brief Cache LRU de tablas de base fija de claves publicas
+ *
+ * Cada clave cuenta sus usos y al llegar a KEY_CACHE_HOT_USES se construye
+ * su tabla (~5 multiplicaciones escalares de coste, fuera del cerrojo).
+ * Las claves frias solo ocupan su entrada. Cuando la memoria estimada
+ * supera max_bytes se expulsan las entradas usadas hace mas tiempo; las
+ * tablas se entregan por shared_ptr, asi que expulsar una no invalida la
+ * que otro hilo este usando.
+ */
+template<class Field>
+class KeyTableCache {
+public:
+    using Table = FixedBaseTable<Field>;
+
+    // point_bytes: memoria estimada de un punto de la tabla
+    explicit KeyTableCache(size_t point_bytes) : point_bytes_(point_bytes) {}
+
+    /**
+     * @brief Tabla de la clave, o nullptr si aun esta fria
+     *
+     * build() construye la tabla cuando la clave se calienta; el uso que
+     * la construye ya la recibe.
+     */
+    template<class Build>
+    std::shared_ptr<const Table> lookup(const std::string& key, size_t max_bytes,
+                                        Build&& build) const {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it == index_.end()) {
+                lru_.push_front(Entry{key, 0, false, false, nullptr, entry_bytes(key)});
+                it = index_.emplace(key, lru_.begin()).first;
+                bytes_ += lru_.front().bytes;
+            } else {
+                lru_.splice(lru_.begin(), lru_, it->second);
+            }
+
+            Entry& e = *it->second;
+            if (e.table) {
+                stats_.hits++;
+                return e.table;
+            }
+            stats_.misses++;
+            e.uses++;
+            // Otro hilo puede estar construyendo ya la tabla de esta clave
+            if (e.uses < KEY_CACHE_HOT_USES || e.building || e.oversize) {
+                evict(max_bytes);
+                return nullptr;
+            }
+            e.building = true;
+        }
+
+        std::shared_ptr<const Table> table;
+        try {
+            table = std::make_shared<const Table>(build());
+        } catch (...) {
+            // Si no, la clave quedaria marcada como en construccion y no
+            // se volveria a intentar mientras siga en la cache
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) it->second->building = false;
+            throw;
+        }
+        size_t table_bytes = table->entries.size() * point_bytes_;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.builds++;
+        auto it = index_.find(key);
+        // La entrada pudo expulsarse mientras se construia
+        if (it != index_.end() && !it->second->table) {
+            Entry& e = *it->second;
+            e.building = false;
+            if (e.bytes + table_bytes <= max_bytes) {
+                e.table = table;
+                e.bytes += table_bytes;
+                bytes_ += table_bytes;
+                stats_.tables++;
+                lru_.splice(lru_.begin(), lru_, it->second);
+            } else {
+                // No cabe ni sola: no se vuelve a construir para esta clave
+                e.oversize = true;
+            }
+        }
+        evict(max_bytes);
+        return table;
+    }
+
+    KeyCacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        KeyCacheStats out = stats_;
+        out.entries = lru_.size();
+        out.bytes = bytes_;
+        return out;
+    }
+
+    void clear() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lru_.clear();
+        index_.clear();
+        bytes_ = 0;
+        stats_ = KeyCacheStats();
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        uint32_t uses;
+        bool building;
+        bool oversize;
+        std::shared_ptr<const Table> table;
+        size_t bytes;
+    };
+
+    // Clave (en la lista y en el indice) mas los nodos de ambos
+    static size_t entry_bytes(const std::string& key) { return 2 * key.size() + 128; }
+
+    // Con el cerrojo tomado
+    void evict(size_t max_bytes) const {
+        while (bytes_ > max_bytes && !lru_.empty()) {
+            const Entry& victim = lru_.back();
+            bytes_ -= victim.bytes;
+            if (victim.table) stats_.tables--;
+            stats_.evictions++;
+            index_.erase(victim.key);
+            lru_.pop_back();
+        }
+    }
+
+    size_t point_bytes_;
+    mutable std::mutex mutex_;
+    mutable std::list<Entry> lru_;      // Delante: usada mas recientemente
+    mutable std::unordered_map<std::string, typename std::list<Entry>::iterator> index_;
+    mutable size_t bytes_ = 0;
+    mutable KeyCacheStats stats_;       // entries y bytes se rellenan en stats()
+};
+
+/**
+ * Todo lo que depende solo de los parametros de la curva y es caro de
+ * reconstruir en cada operacion. Se crea una vez (CurveParams::cache())
+ * y es inmutable a partir de ese momento (salvo los LazySlot, que se
+ * rellenan una sola vez, y las caches de claves, con su propio cerrojo),
+ * por lo que puede compartirse entre hilos.
+ */
+struct CurveCache {
+    ZZ_pContext zzp;    // Modulo p de NTL ya preparado (backend NTL)
+    FpContext fp;       // Campo de tamano fijo (backend MONTGOMERY)
+    CurveShape shape;   // Formula de doblado
+    std::unique_ptr<const GlvParams> glv;   // nullptr si no hay endomorfismo
+
+    // Tablas del generador, una por representacion del campo
+    GeneratorTables<ZZpField> g_ntl;
+    GeneratorTables<FpField<4>> g_f4;
+    GeneratorTables<FpField<6>> g_f6;
+
+    // Tablas de claves publicas calientes, una cache por representacion.
+    // Un ZZ_p guarda sus limbs en el heap: se suman a la estimacion
+    KeyTableCache<ZZpField> k_ntl;
+    KeyTableCache<FpField<4>> k_f4;
+    KeyTableCache<FpField<6>> k_f6;
+
+    explicit CurveCache(const CurveParams& curve)
+        : zzp(curve.p), fp(curve.p), shape(detect_curve_shape(curve)),
+          glv(glv_params_for(curve)),
+          k_ntl(sizeof(NativeJacobian<ZZpField>) + 3 * (NumBytes(curve.p) + 2 * sizeof(long))),
+          k_f4(sizeof(NativeJacobian<FpField<4>>)),
+          k_f6(sizeof(NativeJacobian<FpField<6>>)) {}
+
+    template<class Field>
+    const GeneratorTables<Field>& generator() const {
+        if constexpr (std::is_same<Field, ZZpField>::value) return g_ntl;
+        else if constexpr (std::is_same<Field, FpField<4>>::value) return g_f4;
+        else return g_f6;
+    }
+
+    template<class Field>
+    const KeyTableCache<Field>& key_tables() const {
+        if constexpr (std::is_same<Field, ZZpField>::value) return k_ntl;
+        else if constexpr (std::is_same<Field, FpField<4>>::value) return k_f4;
+        else return k_f6;
+    }
+};
+
+/**
+ * @brief Curva ligada a un campo concreto: constantes convertidas una vez
+ *
+ * Agrupa el campo, la curva y sus coeficientes ya en la representacion
+ * interna, y ofrece las operaciones de grupo. Es el punto de entrada de
+ * los algoritmos de multiplicacion escalar genericos.
+ */
+template<class Field>
+class NativeCurve {
+public:
+    using FieldType = Field;
+    using Elem = typename Field::Elem;
+    using Point = NativeJacobian<Field>;
+
+    NativeCurve(const Field& field, const CurveParams* curve)
+        : F(field), curve_(curve), shape_(curve->cache().shape),
+          a_(field.from_bigint(curve->a)), b_(field.from_bigint(curve->b)),
+          b3_(field.from_bigint(3 * curve->b)) {}
+
+    const Field& F;
+
+    const CurveParams* curve() const { return curve_; }
+
+    Point infinity() const { return Point{F.one(), F.one(), F.zero()}; }
+    bool is_infinity(const Point& P) const { return F.is_zero(P.Z); }
+
+    // Frontera con la API publica: (x, y) -> (x : y : 1) y vuelta
+    Point from_affine(const ECPoint& P) const;
+    ECPoint to_affine(const Point& P) const;
+
+    /** @brief G sin pasar por ECPoint (sin comprobacion de pertenencia) */
+    Point generator() const {
+        return Point{F.from_bigint(curve_->Gx), F.from_bigint(curve_->Gy), F.one()};
+    }
+
+    /** @brief Mismo punto con Z = 1 (una inversion) */
+    Point normalize(const Point& P) const;
+
+    Point neg(const Point& P) const { return Point{P.X, F.neg(P.Y), P.Z}; }
+
+    /** @brief Coeficientes a y b en la representacion del campo */
+    const Elem& a() const { return a_; }
+    const Elem& b() const { return b_; }
+
+    /** @brief Doblado con la formula de la forma de la curva */
+    Point dbl(const Point& P) const;
+
+    /** @brief Suma; usa add_mixed si algun operando tiene Z = 1 */
+    Point add(const Point& P, const Point& Q) const;
+
+    /** @brief Suma mixta P + Q con Q.Z = 1. Coste: 8M + 3S */
+    Point add_mixed(const Point& P, const Point& Q) const;
+
+    // Formulas completas en proyectivas homogeneas (ver complete_add)
+    using ProjPoint = NativeProjective<Field>;
+
+    ProjPoint proj_infinity() const { return ProjPoint{F.zero(), F.one(), F.zero()}; }
+
+    /** @brief Jacobiano -> proyectivo: (X*Z : Y : Z^3), sin inversion */
+    ProjPoint to_projective(const Point& P) const {
+        return ProjPoint{F.mul(P.X, P.Z), P.Y, F.mul(F.sqr(P.Z), P.Z)};
+    }
+
+    /** @brief Proyectivo -> Jacobiano: (X*Z : Y*Z^2 : Z); el infinito queda con Z = 0 */
+    Point from_projective(const ProjPoint& P) const {
+        return Point{F.mul(P.X, P.Z), F.mul(P.Y, F.sqr(P.Z)), P.Z};
+    }
+
+    /** @brief Suma completa (valida para P = Q, P = -Q e infinito) */
+    ProjPoint complete_add(const ProjPoint& P, const ProjPoint& Q) const;
+
+    /** @brief Doblado completo */
+    ProjPoint complete_dbl(const ProjPoint& P) const;
+
+private:
+    const CurveParams* curve_;
+    CurveShape shape_;
+    Elem a_;
+    Elem b_;
+    Elem b3_;           // 3*b, constante de las formulas completas
+};
+
+template<class Field>
+typename NativeCurve<Field>::Point NativeCurve<Field>::from_affine(const ECPoint& P) const {
+    if (P.is_infinity()) return infinity();
+    return Point{F.from_bigint(P.x()), F.from_bigint(P.y()), F.one()};
+}
+
+template<class Field>
+ECPoint NativeCurve<Field>::to_affine(const Point& P) const {
+    if (is_infinity(P)) return ECPoint(curve_);
+
+    // Unica inversion: (X/Z^2, Y/Z^3)
+    Elem Z_inv = F.inv(P.Z);
+    Elem Z_inv2 = F.sqr(Z_inv);
+    Elem Z_inv3 = F.mul(Z_inv2, Z_inv);
+
+    return ECPoint::trusted(F.to_bigint(F.mul(P.X, Z_inv2)),
+                            F.to_bigint(F.mul(P.Y, Z_inv3)), curve_);
+}
+
+template<class Field>
+typename NativeCurve<Field>::Point NativeCurve<Field>::normalize(const Point& P) const {
+    if (is_infinity(P)) return P;
+    Elem Z_inv = F.inv(P.Z);
+    Elem Z_inv2 = F.sqr(Z_inv);
+    return Point{F.mul(P.X, Z_inv2), F.mul(P.Y, F.mul(Z_inv2, Z_inv)), F.one()};
+}
+
+/**
+ * Doblado segun la forma de la curva (formulas de la Explicit-Formulas
+ * Database, Bernstein-Lange):
+ *
+ *   a = 0  (dbl-2009-l):  2M + 5S
+ *     A = X1^2, B = Y1^2, C = B^2, D = 2*((X1+B)^2 - A - C), E = 3A
+ *     X3 = E^2 - 2D, Y3 = E*(D - X3) - 8C, Z3 = 2*Y1*Z1
+ *
+ *   a = -3 (dbl-2001-b):  3M + 5S
+ *     delta = Z1^2, gamma = Y1^2, beta = X1*gamma
+ *     alpha = 3*(X1 - delta)*(X1 + delta)
+ *     X3 = alpha^2 - 8*beta, Z3 = (Y1+Z1)^2 - gamma - delta
+ *     Y3 = alpha*(4*beta - X3) - 8*gamma^2
+ *
+ *   a generico: mismas formulas que jacobian_double, 4M + 4S (+ 1M por a)
+ */
+template<class Field>
+typename NativeCurve<Field>::Point NativeCurve<Field>::dbl(const Point& P) const {
+    if (F.is_zero(P.Z) || F.is_zero(P.Y)) return infinity();
+
+    Point R;
+    if (shape_ == CurveShape::A_ZERO) {
+        Elem A = F.sqr(P.X);
+        Elem B = F.sqr(P.Y);
+        Elem C = F.sqr(B);
+        Elem D = F.dbl(F.sub(F.sub(F.sqr(F.add(P.X, B)), A), C));
+        Elem E3 = F.add(A, F.dbl(A));
+        R.X = F.sub(F.sqr(E3), F.dbl(D));
+        R.Y = F.sub(F.mul(E3, F.sub(D, R.X)), F.dbl(F.dbl(F.dbl(C))));
+        R.Z = F.dbl(F.mul(P.Y, P.Z));
+        return R;
+    }
+
+    if (shape_ == CurveShape::A_MINUS_3) {
+        Elem delta = F.sqr(P.Z);
+        Elem gamma = F.sqr(P.Y);
+        Elem beta = F.mul(P.X, gamma);
+        Elem t = F.mul(F.sub(P.X, delta), F.add(P.X, delta));
+        Elem alpha = F.add(t, F.dbl(t));
+        Elem beta4 = F.dbl(F.dbl(beta));
+        R.X = F.sub(F.sqr(alpha), F.dbl(beta4));
+        R.Z = F.sub(F.sub(F.sqr(F.add(P.Y, P.Z)), gamma), delta);
+        R.Y = F.sub(F.mul(alpha, F.sub(beta4, R.X)),
+                    F.dbl(F.dbl(F.dbl(F.sqr(gamma)))));
+        return R;
+    }
+
+    Elem A = F.sqr(P.Y);                            // A = Y1^2
+    Elem B = F.dbl(F.dbl(F.mul(P.X, A)));           // B = 4*X1*A
+    Elem C = F.dbl(F.dbl(F.dbl(F.sqr(A))));         // C = 8*A^2
+
+    Elem X1_sq = F.sqr(P.X);
+    Elem Z1_sq = F.sqr(P.Z);
+    Elem D = F.add(F.add(X1_sq, F.dbl(X1_sq)),      // D = 3*X1^2 + a*Z1^4
+                   F.mul(a_, F.sqr(Z1_sq)));
+
+    R.X = F.sub(F.sqr(D), F.dbl(B));                // X3 = D^2 - 2B
+    R.Y = F.sub(F.mul(D, F.sub(B, R.X)), C);        // Y3 = D*(B - X3) - C
+    R.Z = F.dbl(F.mul(P.Y, P.Z));                   // Z3 = 2*Y1*Z1
+    return R;
+}
+
+/**
+ * Suma: mismas formulas que jacobian_add, 12M + 4S
+ */
+template<class Field>
+typename NativeCurve<Field>::Point NativeCurve<Field>::add(const Point& P, const Point& Q) const {
+    if (F.is_zero(P.Z)) return Q;
+    if (F.is_zero(Q.Z)) return P;
+    if (F.equal(Q.Z, F.one())) return add_mixed(P, Q);
+    if (F.equal(P.Z, F.one())) return add_mixed(Q, P);
+
+    Elem Z1_sq = F.sqr(P.Z);
+    Elem Z2_sq = F.sqr(Q.Z);
+
+    Elem U1 = F.mul(P.X, Z2_sq);
+    Elem U2 = F.mul(Q.X, Z1_sq);
+    Elem S1 = F.mul(P.Y, F.mul(Z2_sq, Q.Z));
+    Elem S2 = F.mul(Q.Y, F.mul(Z1_sq, P.Z));
+
+    Elem H = F.sub(U2, U1);
+    Elem R = F.sub(S2, S1);
+
+    if (F.is_zero(H)) {
+        if (F.is_zero(R)) return dbl(P);
+        return infinity();
+    }
+
+    Elem H_sq = F.sqr(H);
+    Elem H_cu = F.mul(H_sq, H);
+    Elem U1H2 = F.mul(U1, H_sq);
+
+    Point out;
+    out.X = F.sub(F.sub(F.sqr(R), H_cu), F.dbl(U1H2));
+    out.Y = F.sub(F.mul(R, F.sub(U1H2, out.X)), F.mul(S1, H_cu));
+    out.Z = F.mul(H, F.mul(P.Z, Q.Z));
+    return out;
+}
+
+/**
+ * Suma mixta (Z2 = 1): U1 = X1 y S1 = Y1 salen gratis
+ *   U2 = X2*Z1^2, S2 = Y2*Z1^3, H = U2 - X1, R = S2 - Y1
+ *   X3 = R^2 - H^3 - 2*X1*H^2
+ *   Y3 = R*(X1*H^2 - X3) - Y1*H^3
+ *   Z3 = Z1*H
+ */
+template<class Field>
+typename NativeCurve<Field>::Point NativeCurve<Field>::add_mixed(const Point& P, const Point& Q) const {
+    if (F.is_zero(P.Z)) return Q;
+
+    Elem Z1_sq = F.sqr(P.Z);
+    Elem U2 = F.mul(Q.X, Z1_sq);
+    Elem S2 = F.mul(Q.Y, F.mul(Z1_sq, P.Z));
+
+    Elem H = F.sub(U2, P.X);
+    Elem R = F.sub(S2, P.Y);
+
+    if (F.is_zero(H)) {
+        if (F.is_zero(R)) return dbl(P);
+        return infinity();
+    }
+
+    Elem H_sq = F.sqr(H);
+    Elem H_cu = F.mul(H_sq, H);
+    Elem X1H2 = F.mul(P.X, H_sq);
+
+    Point out;
+    out.X = F.sub(F.sub(F.sqr(R), H_cu), F.dbl(X1H2));
+    out.Y = F.sub(F.mul(R, F.sub(X1H2, out.X)), F.mul(P.Y, H_cu));
+    out.Z = F.mul(P.Z, H);
+    return out;
+}
+
+// ============================================================================
+// FORMULAS COMPLETAS (RENES-COSTELLO-BATINA)
+// ============================================================================
+
+/**
+ * Suma completa en proyectivas homogeneas (Renes, Costello, Batina,
+ * "Complete addition formulas for prime order elliptic curves", 2016).
+ * Validas para cualquier par de puntos de una curva de orden primo
+ * (incluidos P = Q y el infinito): una unica secuencia de operaciones sin
+ * saltos, apta para vectorizar muchas sumas independientes.
+ *
+ *   a = 0  (Alg. 7):  12M + 2m_3b
+ *   a = -3 (Alg. 4):  12M + 2m_b
+ *   a generico (Alg. 1):  12M + 3m_a + 2m_3b
+ */
+template<class Field>
+typename NativeCurve<Field>::ProjPoint
+NativeCurve<Field>::complete_add(const ProjPoint& P, const ProjPoint& Q) const {
+    Elem t0 = F.mul(P.X, Q.X);
+    Elem t1 = F.mul(P.Y, Q.Y);
+    Elem t2 = F.mul(P.Z, Q.Z);
+    Elem t3 = F.sub(F.mul(F.add(P.X, P.Y), F.add(Q.X, Q.Y)), F.add(t0, t1));
+    ProjPoint R;
+
+    if (shape_ == CurveShape::A_ZERO) {
+        Elem t4 = F.sub(F.mul(F.add(P.Y, P.Z), F.add(Q.Y, Q.Z)), F.add(t1, t2));
+        Elem Y3 = F.sub(F.mul(F.add(P.X, P.Z), F.add(Q.X, Q.Z)), F.add(t0, t2));
+        t0 = F.add(F.dbl(t0), t0);
+        t2 = F.mul(b3_, t2);
+        Elem Z3 = F.add(t1, t2);
+        t1 = F.sub(t1, t2);
+        Y3 = F.mul(b3_, Y3);
+        R.X = F.sub(F.mul(t3, t1), F.mul(t4, Y3));
+        R.Y = F.add(F.mul(t1, Z3), F.mul(Y3, t0));
+        R.Z = F.add(F.mul(Z3, t4), F.mul(t0, t3));
+        return R;
+    }
+
+    if (shape_ == CurveShape::A_MINUS_3) {
+        Elem t4 = F.sub(F.mul(F.add(P.Y, P.Z), F.add(Q.Y, Q.Z)), F.add(t1, t2));
+        Elem Y3 = F.sub(F.mul(F.add(P.X, P.Z), F.add(Q.X, Q.Z)), F.add(t0, t2));
+        Elem Z3 = F.mul(b_, t2);
+        Elem X3 = F.sub(Y3, Z3);
+        X3 = F.add(X3, F.dbl(X3));
+        Z3 = F.sub(t1, X3);
+        X3 = F.add(t1, X3);
+        Y3 = F.mul(b_, Y3);
+        t2 = F.add(F.dbl(t2), t2);
+        Y3 = F.sub(F.sub(Y3, t2), t0);
+        Y3 = F.add(F.dbl(Y3), Y3);
+        t0 = F.sub(F.add(F.dbl(t0), t0), t2);
+        R.Y = F.add(F.mul(X3, Z3), F.mul(t0, Y3));
+        R.X = F.sub(F.mul(t3, X3), F.mul(t4, Y3));
+        R.Z = F.add(F.mul(t4, Z3), F.mul(t3, t0));
+        return R;
+    }
+
+    Elem t4 = F.sub(F.mul(F.add(P.X, P.Z), F.add(Q.X, Q.Z)), F.add(t0, t2));
+    Elem t5 = F.sub(F.mul(F.add(P.Y, P.Z), F.add(Q.Y, Q.Z)), F.add(t1, t2));
+    Elem Z3 = F.add(F.mul(b3_, t2), F.mul(a_, t4));
+    Elem X3 = F.sub(t1, Z3);
+    Z3 = F.add(t1, Z3);
+    Elem Y3 = F.mul(X3, Z3);
+    t1 = F.add(F.dbl(t0), t0);
+    t2 = F.mul(a_, t2);
+    t4 = F.add(F.mul(b3_, t4), F.mul(a_, F.sub(t0, t2)));
+    t1 = F.add(t1, t2);
+    R.Y = F.add(Y3, F.mul(t1, t4));
+    R.X = F.sub(F.mul(t3, X3), F.mul(t5, t4));
+    R.Z = F.add(F.mul(t5, Z3), F.mul(t3, t1));
+    return R;
+}
+
+/**
+ * Doblado completo (mismo articulo):
+ *   a = 0  (Alg. 9):  6M + 2S + 1m_3b
+ *   a = -3 (Alg. 6):  8M + 3S + 2m_b
+ *   a generico (Alg. 3):  8M + 3S + 3m_a + 2m_3b
+ */
+template<class Field>
+typename NativeCurve<Field>::ProjPoint
+NativeCurve<Field>::complete_dbl(const ProjPoint& P) const {
+    ProjPoint R;
+
+    if (shape_ == CurveShape::A_ZERO) {
+        Elem t0 = F.sqr(P.Y);
+        Elem Z3 = F.dbl(F.dbl(F.dbl(t0)));
+        Elem t1 = F.mul(P.Y, P.Z);
+        Elem t2 = F.mul(b3_, F.sqr(P.Z));
+        Elem X3 = F.mul(t2, Z3);
+        Elem Y3 = F.add(t0, t2);
+        R.Z = F.mul(t1, Z3);
+        t0 = F.sub(t0, F.add(F.dbl(t2), t2));
+        R.Y = F.add(X3, F.mul(t0, Y3));
+        R.X = F.dbl(F.mul(t0, F.mul(P.X, P.Y)));
+        return R;
+    }
+
+    Elem t0 = F.sqr(P.X);
+    Elem t1 = F.sqr(P.Y);
+    Elem t2 = F.sqr(P.Z);
+    Elem t3 = F.dbl(F.mul(P.X, P.Y));
+    Elem Z3 = F.dbl(F.mul(P.X, P.Z));
+    Elem X3, Y3;
+
+    if (shape_ == CurveShape::A_MINUS_3) {
+        Y3 = F.sub(F.mul(b_, t2), Z3);
+        Y3 = F.add(F.dbl(Y3), Y3);
+        X3 = F.sub(t1, Y3);
+        Y3 = F.mul(X3, F.add(t1, Y3));
+        X3 = F.mul(X3, t3);
+        t2 = F.add(F.dbl(t2), t2);
+        Z3 = F.sub(F.sub(F.mul(b_, Z3), t2), t0);
+        Z3 = F.add(F.dbl(Z3), Z3);
+        t0 = F.sub(F.add(F.dbl(t0), t0), t2);
+        Y3 = F.add(Y3, F.mul(t0, Z3));
+        t0 = F.dbl(F.mul(P.Y, P.Z));
+        R.X = F.sub(X3, F.mul(t0, Z3));
+        R.Y = Y3;
+        R.Z = F.dbl(F.dbl(F.mul(t0, t1)));
+        return R;
+    }
+
+    X3 = F.mul(a_, Z3);
+    Y3 = F.add(X3, F.mul(b3_, t2));
+    X3 = F.sub(t1, Y3);
+    Y3 = F.mul(X3, F.add(t1, Y3));
+    X3 = F.mul(t3, X3);
+    Z3 = F.mul(b3_, Z3);
+    t2 = F.mul(a_, t2);
+    t3 = F.add(F.mul(a_, F.sub(t0, t2)), Z3);
+    t0 = F.add(F.add(F.dbl(t0), t0), t2);
+    Y3 = F.add(Y3, F.mul(t0, t3));
+    t2 = F.dbl(F.mul(P.Y, P.Z));
+    R.X = F.sub(X3, F.mul(t2, t3));
+    R.Y = Y3;
+    R.Z = F.dbl(F.dbl(F.mul(t2, t1)));
+    return R;
+}
+
+// ============================================================================
+// NORMALIZACION POR LOTES (TRUCO DE MONTGOMERY)
+// ============================================================================
+
+/**
+ * @brief Lleva todos los puntos a Z = 1 con una sola inversion
+ *
+ * Inversion simultanea: con los productos acumulados c_i = Z_0 * ... * Z_i,
+ *   inv = (c_{n-1})^(-1)
+ *   Z_i^(-1) = inv * c_{i-1},  inv = inv * Z_i   (de i = n-1 a 0)
+ * Coste: 1I + 3(n-1)M, mas 3M + 1S por punto para escalar X e Y.
+ * Los puntos en el infinito se dejan tal cual.
+ */
+template<class Curve>
+void native_normalize_batch(const Curve& E, std::vector<typename Curve::Point>& points) {
+    using Elem = typename Curve::Elem;
+    const auto& F = E.F;
+    size_t n = points.size();
+    if (n == 0) return;
+
+    // c_i (los infinitos cuentan como Z = 1 para no anular el producto)
+    std::vector<Elem> acc(n);
+    Elem running = F.one();
+    for (size_t i = 0; i < n; i++) {
+        if (!E.is_infinity(points[i])) running = F.mul(running, points[i].Z);
+        acc[i] = running;
+    }
+
+    Elem inv = F.inv(running);
+    for (size_t i = n; i-- > 0; ) {
+        if (E.is_infinity(points[i])) continue;
+        Elem z_inv = (i > 0) ? F.mul(inv, acc[i - 1]) : inv;
+        inv = F.mul(inv, points[i].Z);
+
+        Elem z_inv2 = F.sqr(z_inv);
+        points[i].X = F.mul(points[i].X, z_inv2);
+        points[i].Y = F.mul(points[i].Y, F.mul(z_inv2, z_inv));
+        points[i].Z = F.one();
+    }
+}
+
+/**
+ * @brief to_affine de un vector de puntos con una sola inversion
+ */
+template<class Curve>
+std::vector<ECPoint> native_to_affine_batch(const Curve& E,
+                                            std::vector<typename Curve::Point> points) {
+    native_normalize_batch(E, points);
+
+    std::vector<ECPoint> out;
+    out.reserve(points.size());
+    for (const auto& P : points) {
+        if (E.is_infinity(P)) {
+            out.push_back(ECPoint(E.curve()));
+        } else {
+            out.push_back(ECPoint::trusted(E.F.to_bigint(P.X), E.F.to_bigint(P.Y), E.curve()));
+        }
+    }
+    return out;
+}
+
+// ============================================================================
+// SELECCION DEL BACKEND
+// ============================================================================
+
+/**
+ * @brief Ejecuta fn(E) con la NativeCurve del backend de la curva
+ *
+ * MONTGOMERY usa FpField<4> o FpField<6> segun el tamano de p (si p no
+ * cabe, se cae a NTL); NTL usa ZZpField. fn debe ser una lambda generica
+ * (const auto& E) y devolver el mismo tipo para todos los campos.
+ */
+template<class Fn>
+auto with_native_curve(const CurveParams& curve, Fn&& fn)
+    -> decltype(fn(std::declval<const NativeCurve<ZZpField>&>())) {
+    if (curve.backend == FieldBackend::MONTGOMERY) {
+        const FpContext& fp = curve.cache().fp;
+        if (fp.f4) return fn(NativeCurve<FpField<4>>(*fp.f4, &curve));
+        if (fp.f6) return fn(NativeCurve<FpField<6>>(*fp.f6, &curve));
+    }
+    ZZpField field(curve);
+    return fn(NativeCurve<ZZpField>(field, &curve));
+}
+
+// ============================================================================
+// MULTIPLICACION ESCALAR
+// ============================================================================
+
+/**
+ * Double-and-add (izquierda a derecha) recorriendo los bits de k con bit(),
+ * sin divisiones de BigInt en el bucle. Siempre se suma el mismo P, asi
+ * que si P llega en afin (Z = 1) cada suma es mixta.
+ */
+template<class Curve>
+typename Curve::Point native_scalar_mult(const Curve& E, const BigInt& k,
+                                         const typename Curve::Point& P) {
+    typename Curve::Point result = E.infinity();
+
+    for (long i = NumBits(k) - 1; i >= 0; i--) {
+        result = E.dbl(result);
+        if (bit(k, i)) {
+            result = E.add(result, P);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Recodificacion wNAF de k >= 0 (digito i = coeficiente de 2^i)
+ *
+ * Solo consulta bits de k (sin aritmetica BigInt en el bucle).
+ */
+std::vector<int> wnaf_recode(const BigInt& k, int w);
+
+/**
+ * @brief Tabla de multiplos impares P, 3P, 5P, ..., (2*count - 1)P
+ */
+template<class Curve>
+std::vector<typename Curve::Point> native_odd_multiples(const Curve& E,
+                                                        const typename Curve::Point& P,
+                                                        size_t count) {
+    std::vector<typename Curve::Point> table;
+    table.reserve(count);
+    table.push_back(P);
+    if (count > 1) {
+        typename Curve::Point P2 = E.dbl(P);
+        for (size_t i = 1; i < count; i++) {
+            table.push_back(E.add(table.back(), P2));
+        }
+    }
+    return table;
+}
+
+/**
+ * wNAF izquierda a derecha: un doblado por digito y una suma (o resta,
+ * negando la entrada de la tabla) por digito no nulo
+ */
+template<class Curve>
+typename Curve::Point native_scalar_mult_wnaf(const Curve& E, const BigInt& k,
+                                              const typename Curve::Point& P, int w) {
+    std::vector<int> naf = wnaf_recode(k, w);
+    std::vector<typename Curve::Point> table = native_odd_multiples(E, P, size_t(1) << (w - 2));
+
+    typename Curve::Point result = E.infinity();
+    for (long i = (long)naf.size() - 1; i >= 0; i--) {
+        result = E.dbl(result);
+        int d = naf[i];
+        if (d > 0) {
+            result = E.add(result, table[d >> 1]);
+        } else if (d < 0) {
+            result = E.add(result, E.neg(table[(-d) >> 1]));
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// MULTIPLICACION DE BASE FIJA
+// ============================================================================
+
+/**
+ * @brief Construye la tabla de base fija de B para escalares en [0, n)
+ *
+ * windows * WINDOW >= bits(n) + 1 para que el acarreo de la ultima
+ * ventana sea siempre 0.
+ */
+template<class Curve>
+FixedBaseTable<typename Curve::FieldType> native_build_fixed_base(const Curve& E,
+                                                                  const typename Curve::Point& B) {
+    using Table = FixedBaseTable<typename Curve::FieldType>;
+    Table T;
+    T.windows = (NumBits(E.curve()->n) + Table::WINDOW) / Table::WINDOW;
+    T.entries.reserve(T.windows * Table::ROW);
+
+    typename Curve::Point base = B;                   // 2^(w*i) * B
+    for (long i = 0; i < T.windows; i++) {
+        typename Curve::Point acc = base;
+        for (int j = 1; j <= Table::ROW; j++) {
+            T.entries.push_back(acc);
+            acc = E.add(acc, base);
+        }
+        for (int j = 0; j < Table::WINDOW; j++) {
+            base = E.dbl(base);
+        }
+    }
+
+    // Todas las entradas a Z = 1 con una sola inversion
+    native_normalize_batch(E, T.entries);
+    return T;
+}
+
+/**
+ * k*B con la tabla de B, 0 <= k < n: una suma por ventana con digito no nulo
+ */
+template<class Curve>
+typename Curve::Point native_fixed_base_mult(const Curve& E,
+                                             const FixedBaseTable<typename Curve::FieldType>& T,
+                                             const BigInt& k) {
+    using Table = FixedBaseTable<typename Curve::FieldType>;
+    typename Curve::Point result = E.infinity();
+
+    int carry = 0;
+    for (long i = 0; i < T.windows; i++) {
+        int v = carry;
+        for (int j = 0; j < Table::WINDOW; j++) {
+            v += (int)bit(k, i * Table::WINDOW + j) << j;
+        }
+        // v en [0, 2^w]: por encima de 2^(w-1) se usa v - 2^w y se acarrea 1
+        carry = (v > Table::ROW) ? 1 : 0;
+        int d = v - (carry << Table::WINDOW);
+        if (d > 0) {
+            result = E.add(result, T.entry(i, d));
+        } else if (d < 0) {
+            result = E.add(result, E.neg(T.entry(i, -d)));
+        }
+    }
+    return result;
+}
+
+/**
+ * k*G con la tabla de G guardada en la cache de la curva (se construye la
+ * primera vez que se usa cada representacion del campo)
+ */
+template<class Curve>
+typename Curve::Point native_generator_mult(const Curve& E, const BigInt& k) {
+    const auto& table = E.curve()->cache().template generator<typename Curve::FieldType>().fixed.get(
+        [&]() { return native_build_fixed_base(E, E.generator()); });
+    return native_fixed_base_mult(E, table, k);
+}
+
+/**
+ * @brief Tabla de base fija de la clave publica Q si esta caliente en la
+ * cache de la curva, o nullptr (cache desactivada, Q fria o en el infinito)
+ */
+template<class Curve>
+std::shared_ptr<const FixedBaseTable<typename Curve::FieldType>>
+native_key_table(const Curve& E, const ECPoint& Q) {
+    const CurveParams* curve = E.curve();
+    if (curve->key_cache_bytes == 0 || Q.is_infinity()) return nullptr;
+    return curve->cache().template key_tables<typename Curve::FieldType>().lookup(
+        point_cache_key(Q), curve->key_cache_bytes,
+        [&]() { return native_build_fixed_base(E, E.from_affine(Q)); });
+}
+
+// ============================================================================
+// MULTIPLICACION MULTIPLE (STRAUSS / SHAMIR)
+// ============================================================================
+
+/**
+ * @brief sum k_i * P_i con wNAF entrelazado: una unica cadena de doblados
+ *
+ * nafs[i] es la recodificacion wNAF de k_i y tables[i] sus multiplos
+ * impares (tables[i][j] = (2j+1) P_i). Coste: max(len) doblados + una suma
+ * por digito no nulo de cada escalar, en lugar de una cadena de doblados
+ * por termino.
+ */
+template<class Curve>
+typename Curve::Point native_interleaved_wnaf(
+        const Curve& E, const std::vector<std::vector<int>>& nafs,
+        const std::vector<const std::vector<typename Curve::Point>*>& tables) {
+    size_t len = 0;
+    for (const auto& naf : nafs) len = std::max(len, naf.size());
+
+    typename Curve::Point result = E.infinity();
+    for (long i = (long)len - 1; i >= 0; i--) {
+        result = E.dbl(result);
+        for (size_t t = 0; t < nafs.size(); t++) {
+            if ((size_t)i >= nafs[t].size()) continue;
+            int d = nafs[t][i];
+            if (d > 0) {
+                result = E.add(result, (*tables[t])[d >> 1]);
+            } else if (d < 0) {
+                result = E.add(result, E.neg((*tables[t])[(-d) >> 1]));
+            }
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// ENDOMORFISMO GLV
+// ============================================================================
+
+/**
+ * Anade los dos terminos GLV de k*P a una suma entrelazada:
+ *   k*P = k1*P + k2*phi(P),  con phi(X : Y : Z) = (beta*X : Y : Z)
+ * odd es la tabla de multiplos impares de P; la de phi(P) se obtiene
+ * multiplicando sus X por beta (una mul por entrada, sin sumas de puntos).
+ * Los signos de k1, k2 se absorben negando la tabla. storage mantiene
+ * vivas las tablas derivadas (deque: push_back no invalida referencias).
+ */
+template<class Curve>
+void native_glv_terms(const Curve& E, const GlvParams& glv, const BigInt& k,
+                      const std::vector<typename Curve::Point>& odd, int w,
+                      std::vector<std::vector<int>>& nafs,
+                      std::vector<const std::vector<typename Curve::Point>*>& tables,
+                      std::deque<std::vector<typename Curve::Point>>& storage) {
+    BigInt k1, k2;
+    glv_split(glv, E.curve()->n, k, k1, k2);
+
+    if (sign(k1) < 0) {
+        storage.emplace_back();
+        for (const auto& P : odd) storage.back().push_back(E.neg(P));
+        tables.push_back(&storage.back());
+    } else {
+        tables.push_back(&odd);
+    }
+    nafs.push_back(wnaf_recode(abs(k1), w));
+
+    typename Curve::Elem beta = E.F.from_bigint(glv.beta);
+    storage.emplace_back();
+    for (const auto& P : odd) {
+        typename Curve::Point phi{E.F.mul(P.X, beta), P.Y, P.Z};
+        storage.back().push_back(sign(k2) < 0 ? E.neg(phi) : phi);
+    }
+    tables.push_back(&storage.back());
+    nafs.push_back(wnaf_recode(abs(k2), w));
+}
+
+/**
+ * k*P por GLV: dos escalares de ~bits/2 con wNAF entrelazado, es decir
+ * ~bits/2 doblados en lugar de ~bits
+ */
+template<class Curve>
+typename Curve::Point native_scalar_mult_glv(const Curve& E, const GlvParams& glv,
+                                             const BigInt& k,
+                                             const typename Curve::Point& P, int w) {
+    std::vector<typename Curve::Point> odd = native_odd_multiples(E, P, size_t(1) << (w - 2));
+
+    std::vector<std::vector<int>> nafs;
+    std::vector<const std::vector<typename Curve::Point>*> tables;
+    std::deque<std::vector<typename Curve::Point>> storage;
+    native_glv_terms(E, glv, k, odd, w, nafs, tables, storage);
+    return native_interleaved_wnaf(E, nafs, tables);
+}
+
+/**
+ * @brief Constantes GLV a usar para la curva de E, o nullptr
+ *
+ * Solo si la curva tiene endomorfismo y CurveParams::use_endomorphism.
+ */
+template<class Curve>
+const GlvParams* native_glv(const Curve& E) {
+    return E.curve()->use_endomorphism ? E.curve()->cache().glv.get() : nullptr;
+}
+
+// ============================================================================
+// ESCALERA DE MONTGOMERY CO-Z
+// ============================================================================
+
+/**
+ * Suma co-Z (ZADDU, Goundar-Joye-Miyaji 2011): P y Q comparten Z.
+ * Deja P + Q en (Xs, Ys), P actualizado a la nueva Z en (Xp, Yp) y
+ * Z *= (Xp - Xq). Coste: 5M + 2S.
+ *   C = (X1-X2)^2, W1 = X1*C, W2 = X2*C, A1 = Y1*(W1-W2)
+ *   X3 = (Y1-Y2)^2 - W1 - W2, Y3 = (Y1-Y2)*(W1-X3) - A1, P' = (W1, A1)
+ */
+template<class Field>
+void native_zaddu(const Field& F, typename Field::Elem& Xp, typename Field::Elem& Yp,
+                  const typename Field::Elem& Xq, const typename Field::Elem& Yq,
+                  typename Field::Elem& Xs, typename Field::Elem& Ys,
+                  typename Field::Elem& Z) {
+    typename Field::Elem H = F.sub(Xp, Xq);
+    typename Field::Elem C = F.sqr(H);
+    typename Field::Elem W1 = F.mul(Xp, C);
+    typename Field::Elem W2 = F.mul(Xq, C);
+    typename Field::Elem A1 = F.mul(Yp, F.sub(W1, W2));
+    typename Field::Elem R = F.sub(Yp, Yq);
+
+    Xs = F.sub(F.sub(F.sqr(R), W1), W2);
+    Ys = F.sub(F.mul(R, F.sub(W1, Xs)), A1);
+    Xp = W1;
+    Yp = A1;
+    Z = F.mul(Z, H);
+}
+
+/**
+ * Suma conjugada co-Z (ZADDC): P + Q en (Xs, Ys) y P - Q en (Xd, Yd),
+ * ambos con la nueva Z = Z*(Xp - Xq). Mismas W1, W2, A1 que ZADDU mas
+ * (Y1+Y2)^2 para la diferencia. Coste: 6M + 3S.
+ * En ambas las salidas pueden ser las mismas variables que las entradas.
+ */
+template<class Field>
+void native_zaddc(const Field& F, const typename Field::Elem& Xp, const typename Field::Elem& Yp,
+                  const typename Field::Elem& Xq, const typename Field::Elem& Yq,
+                  typename Field::Elem& Xs, typename Field::Elem& Ys,
+                  typename Field::Elem& Xd, typename Field::Elem& Yd,
+                  typename Field::Elem& Z) {
+    typename Field::Elem H = F.sub(Xp, Xq);
+    typename Field::Elem C = F.sqr(H);
+    typename Field::Elem W1 = F.mul(Xp, C);
+    typename Field::Elem W2 = F.mul(Xq, C);
+    typename Field::Elem A1 = F.mul(Yp, F.sub(W1, W2));
+    typename Field::Elem R = F.sub(Yp, Yq);
+    typename Field::Elem T = F.add(Yp, Yq);
+
+    Xs = F.sub(F.sub(F.sqr(R), W1), W2);
+    Ys = F.sub(F.mul(R, F.sub(W1, Xs)), A1);
+    Xd = F.sub(F.sub(F.sqr(T), W1), W2);
+    Yd = F.sub(F.mul(T, F.sub(W1, Xd)), A1);
+    Z = F.mul(Z, H);
+}
+
+/**
+ * @brief k*P con la escalera de Montgomery co-Z (ejecucion regular)
+ *
+ * Invariante R1 - R0 = P. Por cada bit b, tras un intercambio condicional
+ * (R0, R1) <- (R_b, R_1-b):
+ *   (R1, R0) = ZADDC(R0, R1)       R1 = R0 + R1, R0 = +-P
+ *   (R0, R1) = ZADDU(R1, R0)       R0 = 2*R_b (+P), R1 = R0 + P
+ * Coste fijo: 11M + 5S por bit, la misma secuencia de operaciones de
+ * campo para cualquier k.
+ *
+ * Para que el numero de vueltas no dependa de k se usa k' = k + n o
+ * k + 2n, que tiene siempre bits(n) + 1 bits (k'*P = k*P); la eleccion
+ * es aritmetica (segun el bit alto de k + n), sin saltos. Los bits solo
+ * deciden los intercambios, que son con mascara en FpField.
+ *
+ * Las formulas co-Z fallan (Z = 0) si un prefijo j de k' da jP, (j+1)P
+ * o (2j+1)P en el infinito. Como k' < 3n, eso solo puede pasar en las
+ * LADDER_COMPLETE_TAIL ultimas vueltas (p.ej. k = 1, n - 2, n - 1): esas
+ * se hacen con la misma escalera sobre las formulas completas, que
+ * admiten el infinito, asi que ningun k sale del camino regular.
+ * Con ZZ_p (NTL) la aritmetica de campo en si no es de tiempo constante:
+ * la garantia completa es con FpField.
+ */
+template<class Curve>
+typename Curve::Point native_scalar_mult_ladder(const Curve& E, const BigInt& k,
+                                                const typename Curve::Point& P_in) {
+    using Elem = typename Curve::Elem;
+    const auto& F = E.F;
+    const BigInt& n = E.curve()->n;
+
+    BigInt k_red = k % n;
+    if (IsZero(k_red) || E.is_infinity(P_in)) return E.infinity();
+
+    long nbits = NumBits(n);
+    BigInt kk = k_red + n;
+    kk += (1 - bit(kk, nbits)) * n;
+
+    typename Curve::Point P = F.equal(P_in.Z, F.one()) ? P_in : E.normalize(P_in);
+
+    // (R1, R0) = DBLU(P): 2P y P con la misma Z = 2*Y (P tiene Z = 1)
+    //   B = X^2, E = Y^2, L = E^2, S = 4*X*E = 2*((X+E)^2 - B - L)
+    //   M = 3B + a, 2P = (M^2 - 2S, M*(S - X(2P)) - 8L, 2Y), P' = (S, 8L, 2Y)
+    Elem B = F.sqr(P.X);
+    Elem Ysq = F.sqr(P.Y);
+    Elem L8 = F.dbl(F.dbl(F.dbl(F.sqr(Ysq))));
+    Elem S = F.dbl(F.sub(F.sub(F.sqr(F.add(P.X, Ysq)), B), F.sqr(Ysq)));
+    Elem M = F.add(F.add(B, F.dbl(B)), E.a());
+
+    Elem X0 = S, Y0 = L8;
+    Elem X1 = F.sub(F.sqr(M), F.dbl(S));
+    Elem Y1 = F.sub(F.mul(M, F.sub(S, X1)), L8);
+    Elem Z = F.dbl(P.Y);
+
+    // El bit de arriba de k' (siempre 1) ya esta en R0 = P, R1 = 2P.
+    // Hasta el bit LADDER_COMPLETE_TAIL los multiplos intermedios son
+    // menores que n (k'/8 + 2 < 3n/8 + 2) y las formulas co-Z no fallan
+    constexpr long LADDER_COMPLETE_TAIL = 3;
+    long tail = std::min(LADDER_COMPLETE_TAIL, nbits);
+    uint64_t swapped = 0;
+    for (long i = nbits - 1; i >= tail; i--) {
+        uint64_t b = (uint64_t)bit(kk, i);
+        F.cswap(X0, X1, swapped ^ b);
+        F.cswap(Y0, Y1, swapped ^ b);
+        swapped = b;
+
+        native_zaddc(F, X0, Y0, X1, Y1, X1, Y1, X0, Y0, Z);
+        native_zaddu(F, X1, Y1, X0, Y0, X0, Y0, Z);
+    }
+    F.cswap(X0, X1, swapped);
+    F.cswap(Y0, Y1, swapped);
+
+    // Ultimos bits con formulas completas: R1 = R0 + R1, R0 = 2*R0 tras
+    // intercambiar segun el bit (y deshacer el intercambio)
+    using ProjPoint = typename Curve::ProjPoint;
+    ProjPoint Q0 = E.to_projective(typename Curve::Point{X0, Y0, Z});
+    ProjPoint Q1 = E.to_projective(typename Curve::Point{X1, Y1, Z});
+    for (long i = tail - 1; i >= 0; i--) {
+        uint64_t b = (uint64_t)bit(kk, i);
+        F.cswap(Q0.X, Q1.X, b);
+        F.cswap(Q0.Y, Q1.Y, b);
+        F.cswap(Q0.Z, Q1.Z, b);
+        Q1 = E.complete_add(Q0, Q1);
+        Q0 = E.complete_dbl(Q0);
+        F.cswap(Q0.X, Q1.X, b);
+        F.cswap(Q0.Y, Q1.Y, b);
+        F.cswap(Q0.Z, Q1.Z, b);
+    }
+    return E.from_projective(Q0);
+}
+
+// ============================================================================
+// MULTIPLICACION CON FORMULAS COMPLETAS
+// ============================================================================
+
+/**
+ * @brief Seleccion sin saltos: R = table[d] recorriendo toda la tabla
+ *
+ * Cada entrada se intercambia con mascara (j == d) sobre una copia, asi
+ * que el patron de accesos a memoria no depende de d.
+ */
+template<class Curve>
+typename Curve::ProjPoint native_select_complete(const Curve& E,
+                                                 const std::vector<typename Curve::ProjPoint>& table,
+                                                 uint64_t d) {
+    typename Curve::ProjPoint R = table[0];
+    for (size_t j = 1; j < table.size(); j++) {
+        uint64_t eq = ((uint64_t)(j ^ d) - 1) >> 63;     // 1 si j == d
+        typename Curve::ProjPoint T = table[j];
+        E.F.cswap(R.X, T.X, eq);
+        E.F.cswap(R.Y, T.Y, eq);
+        E.F.cswap(R.Z, T.Z, eq);
+    }
+    return R;
+}
+
+/**
+ * @brief k*P en linea recta con las formulas completas
+ *
+ * Ventana fija de COMPLETE_WINDOW bits sin signo: tabla 0..2^w - 1 de
+ * multiplos de P (0 = infinito, valido gracias a la suma completa) y
+ * ceil(bits(n)/w) vueltas de w doblados + una seleccion sin saltos + una
+ * suma. El numero de vueltas depende de n, no de k, y ninguna formula
+ * tiene casos especiales. P-256: 256 doblados + 64 sumas + 14 de tabla.
+ */
+template<class Curve>
+typename Curve::Point native_scalar_mult_complete(const Curve& E, const BigInt& k,
+                                                  const typename Curve::Point& P) {
+    constexpr int COMPLETE_WINDOW = 4;
+    using ProjPoint = typename Curve::ProjPoint;
+    BigInt k_red = k % E.curve()->n;
+
+    std::vector<ProjPoint> table(size_t(1) << COMPLETE_WINDOW);
+    table[0] = E.proj_infinity();
+    table[1] = E.to_projective(P);
+    for (size_t j = 2; j < table.size(); j++) {
+        table[j] = (j % 2 == 0) ? E.complete_dbl(table[j / 2])
+                                : E.complete_add(table[j - 1], table[1]);
+    }
+
+    long windows = (NumBits(E.curve()->n) + COMPLETE_WINDOW - 1) / COMPLETE_WINDOW;
+    ProjPoint R = E.proj_infinity();
+    for (long i = windows - 1; i >= 0; i--) {
+        for (int j = 0; j < COMPLETE_WINDOW; j++) R = E.complete_dbl(R);
+        uint64_t d = 0;
+        for (int j = COMPLETE_WINDOW - 1; j >= 0; j--) {
+            d = (d << 1) | (uint64_t)bit(k_red, i * COMPLETE_WINDOW + j);
+        }
+        R = E.complete_add(R, native_select_complete(E, table, d));
+    }
+    return E.from_projective(R);
+}
+
+// ============================================================================
+// SELECCION DEL ALGORITMO
+// ============================================================================
+
+/**
+ * k*P con el algoritmo elegido en la curva: los metodos regulares (LADDER,
+ * COMPLETE) si se piden; si no GLV si la curva tiene endomorfismo (y no se
+ * ha desactivado), y si no CurveParams::scalar_method
+ */
+template<class Curve>
+typename Curve::Point native_scalar_mult_method(const Curve& E, const BigInt& k,
+                                                const typename Curve::Point& P) {
+    if (E.curve()->scalar_method == ScalarMethod::LADDER) {
+        return native_scalar_mult_ladder(E, k, P);
+    }
+    if (E.curve()->scalar_method == ScalarMethod::COMPLETE) {
+        return native_scalar_mult_complete(E, k, P);
+    }
+    if (const GlvParams* glv = native_glv(E)) {
+        return native_scalar_mult_glv(E, *glv, k, P, E.curve()->wnaf_width);
+    }
+    if (E.curve()->scalar_method == ScalarMethod::WNAF) {
+        return native_scalar_mult_wnaf(E, k, P, E.curve()->wnaf_width);
+    }
+    return native_scalar_mult(E, k, P);
+}
+
+/**
+ * k*G: un metodo regular si scalar_method es LADDER o COMPLETE (claves y
+ * nonces de firma); si no la tabla de base fija, cuyo acceso depende de
+ * los digitos de k
+ */
+template<class Curve>
+typename Curve::Point native_generator_mult_method(const Curve& E, const BigInt& k) {
+    ScalarMethod method = E.curve()->scalar_method;
+    if (method == ScalarMethod::LADDER || method == ScalarMethod::COMPLETE) {
+        return native_scalar_mult_method(E, k, E.generator());
+    }
+    return native_generator_mult(E, k);
+}
+
+/**
+ * u1*G + u2*Q (verificacion ECDSA): G usa su tabla impar cacheada de ancho
+ * G_WNAF_WIDTH y Q una tabla de ancho w construida en cada llamada.
+ * Con GLV son cuatro terminos de ~bits/2 (G, phi(G), Q, phi(Q)).
+ */
+template<class Curve>
+typename Curve::Point native_generator_mult_add(const Curve& E, const BigInt& u1,
+                                                const BigInt& u2,
+                                                const typename Curve::Point& Q, int w) {
+    using Tables = GeneratorTables<typename Curve::FieldType>;
+    const auto& g_odd = E.curve()->cache().template generator<typename Curve::FieldType>().odd.get(
+        [&]() {
+            auto odd = native_odd_multiples(E, E.generator(), size_t(1) << (Tables::G_WNAF_WIDTH - 2));
+            native_normalize_batch(E, odd);
+            return odd;
+        });
+    std::vector<typename Curve::Point> q_odd = native_odd_multiples(E, Q, size_t(1) << (w - 2));
+
+    if (const GlvParams* glv = native_glv(E)) {
+        std::vector<std::vector<int>> nafs;
+        std::vector<const std::vector<typename Curve::Point>*> tables;
+        std::deque<std::vector<typename Curve::Point>> storage;
+        native_glv_terms(E, *glv, u1, g_odd, Tables::G_WNAF_WIDTH, nafs, tables, storage);
+        native_glv_terms(E, *glv, u2, q_odd, w, nafs, tables, storage);
+        return native_interleaved_wnaf(E, nafs, tables);
+    }
+
+    return native_interleaved_wnaf(E,
+        {wnaf_recode(u1, Tables::G_WNAF_WIDTH), wnaf_recode(u2, w)},
+        {&g_odd, &q_odd});
+}
+
+/**
+ * u1*G + u2*Q con la cache de claves: si Q tiene tabla, dos
+ * multiplicaciones de base fija (sin doblados); si no,
+ * native_generator_mult_add
+ */
+template<class Curve>
+typename Curve::Point native_generator_mult_add_key(const Curve& E, const BigInt& u1,
+                                                    const BigInt& u2, const ECPoint& Q) {
+    if (auto table = native_key_table(E, Q)) {
+        return E.add(native_generator_mult(E, u1), native_fixed_base_mult(E, *table, u2));
+    }
+    return native_generator_mult_add(E, u1, u2, E.from_affine(Q), E.curve()->wnaf_width);
+}
+
+/**
+ * k*Q de ECDH: con la tabla de Q si esta caliente, si no el metodo de la
+ * curva. Los metodos regulares no consultan la cache.
+ */
+template<class Curve>
+typename Curve::Point native_key_mult(const Curve& E, const BigInt& k, const ECPoint& Q) {
+    ScalarMethod method = E.curve()->scalar_method;
+    if (method != ScalarMethod::LADDER && method != ScalarMethod::COMPLETE) {
+        if (auto table = native_key_table(E, Q)) {
+            return native_fixed_base_mult(E, *table, k);
+        }
+    }
+    return native_scalar_mult_method(E, k, E.from_affine(Q));
+}
+
+// ============================================================================
+// MULTIPLICACION MULTIESCALAR (STRAUS / PIPPENGER)
+// ============================================================================
+
+/**
+ * @brief Digitos con signo de ventana fija c: k = sum d_i * 2^(c*i)
+ *
+ * d_i en [-2^(c-1), 2^(c-1)]; digits debe cubrir bits(k)/c + 1 (el
+ * ultimo digito absorbe el acarreo).
+ */
+std::vector<int> signed_window_recode(const BigInt& k, int c, long digits);
+
+/**
+ * @brief Ancho de ventana de Pippenger que minimiza el numero de sumas
+ *
+ * Por ventana: una suma por termino + 2^c para recorrer 2^(c-1) cubos
+ * (suma acumulada); ceil(bits/c) ventanas.
+ */
+inline int pippenger_window(size_t count, long bits) {
+    int best = 2;
+    double best_cost = 0;
+    for (int c = 2; c <= 20; c++) {
+        double cost = double((bits + c - 1) / c) * (double(count) + double(1L << c));
+        if (c == 2 || cost < best_cost) {
+            best = c;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+/**
+ * Straus: wNAF entrelazado de ancho MSM_STRAUS_WIDTH con una tabla de
+ * multiplos impares por punto, todas normalizadas con una sola inversion
+ * (las sumas del bucle son mixtas). Coste: bits doblados + ~n*bits/(w+1)
+ * sumas.
+ */
+template<class Curve>
+typename Curve::Point native_msm_straus(const Curve& E, const std::vector<BigInt>& scalars,
+                                        const std::vector<typename Curve::Point>& points) {
+    constexpr int MSM_STRAUS_WIDTH = 5;
+    const size_t row = size_t(1) << (MSM_STRAUS_WIDTH - 2);
+
+    std::vector<typename Curve::Point> flat;
+    flat.reserve(points.size() * row);
+    for (const auto& P : points) {
+        auto odd = native_odd_multiples(E, P, row);
+        flat.insert(flat.end(), odd.begin(), odd.end());
+    }
+    native_normalize_batch(E, flat);
+
+    std::vector<std::vector<typename Curve::Point>> odd(points.size());
+    std::vector<std::vector<int>> nafs(points.size());
+    std::vector<const std::vector<typename Curve::Point>*> tables(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        odd[i].assign(flat.begin() + i * row, flat.begin() + (i + 1) * row);
+        nafs[i] = wnaf_recode(scalars[i], MSM_STRAUS_WIDTH);
+        tables[i] = &odd[i];
+    }
+    return native_interleaved_wnaf(E, nafs, tables);
+}
+
+/**
+ * Pippenger (metodo de cubos) con digitos con signo de c bits:
+ *   por ventana, de la mas alta a la mas baja:
+ *     R = 2^c * R
+ *     cubo[|d_i| - 1] += sign(d_i) * P_i     (una suma mixta por termino)
+ *     R += sum j * cubo[j-1]                 (suma acumulada: 2^c sumas)
+ * Coste ~ (bits/c) * (n + 2^c) sumas + bits doblados, independiente del
+ * tamano de tabla por punto: gana a Straus cuando n es grande.
+ * Los puntos deben tener Z = 1 para que las sumas a los cubos sean mixtas.
+ */
+template<class Curve>
+typename Curve::Point native_msm_pippenger(const Curve& E, const std::vector<BigInt>& scalars,
+                                           const std::vector<typename Curve::Point>& points) {
+    long bits = 0;
+    for (const auto& k : scalars) bits = std::max(bits, NumBits(k));
+    if (bits == 0) return E.infinity();
+
+    int c = pippenger_window(points.size(), bits);
+    long digits = bits / c + 1;
+
+    std::vector<std::vector<int>> recoded(scalars.size());
+    for (size_t i = 0; i < scalars.size(); i++) {
+        recoded[i] = signed_window_recode(scalars[i], c, digits);
+    }
+
+    std::vector<typename Curve::Point> buckets(size_t(1) << (c - 1));
+    typename Curve::Point R = E.infinity();
+    for (long w = digits - 1; w >= 0; w--) {
+        for (int j = 0; j < c; j++) R = E.dbl(R);
+
+        std::fill(buckets.begin(), buckets.end(), E.infinity());
+        for (size_t i = 0; i < points.size(); i++) {
+            int d = recoded[i][w];
+            if (d > 0) {
+                buckets[d - 1] = E.add(buckets[d - 1], points[i]);
+            } else if (d < 0) {
+                buckets[-d - 1] = E.add(buckets[-d - 1], E.neg(points[i]));
+            }
+        }
+
+        // sum j * cubo[j-1] = sum de las sumas parciales desde arriba
+        typename Curve::Point running = E.infinity();
+        typename Curve::Point total = E.infinity();
+        for (size_t j = buckets.size(); j-- > 0;) {
+            running = E.add(running, buckets[j]);
+            total = E.add(total, running);
+        }
+        R = E.add(R, total);
+    }
+    return R;
+}
+
+/**
+ * @brief sum k_i * P_i eligiendo Straus o Pippenger
+ *
+ * scalars en [0, n) y points con Z = 1. Con GLV cada termino se parte en
+ * dos de ~bits/2 (k1 * (+-P), k2 * (+-phi(P))), lo que reduce a la mitad
+ * los doblados de Straus y las ventanas de Pippenger.
+ */
+template<class Curve>
+typename Curve::Point native_multi_scalar_mult(const Curve& E, std::vector<BigInt> scalars,
+                                               std::vector<typename Curve::Point> points,
+                                               MultiScalarMethod method) {
+    if (const GlvParams* glv = native_glv(E)) {
+        typename Curve::Elem beta = E.F.from_bigint(glv->beta);
+        size_t count = points.size();
+        for (size_t i = 0; i < count; i++) {
+            BigInt k1, k2;
+            glv_split(*glv, E.curve()->n, scalars[i], k1, k2);
+            typename Curve::Point phi{E.F.mul(points[i].X, beta), points[i].Y, points[i].Z};
+            if (sign(k1) < 0) points[i] = E.neg(points[i]);
+            scalars[i] = abs(k1);
+            points.push_back(sign(k2) < 0 ? E.neg(phi) : phi);
+            scalars.push_back(abs(k2));
+        }
+    }
+
+    if (method == MultiScalarMethod::AUTO) {
+        method = (points.size() < MSM_PIPPENGER_THRESHOLD)
+            ? MultiScalarMethod::STRAUS : MultiScalarMethod::PIPPENGER;
+    }
+    return (method == MultiScalarMethod::STRAUS)
+        ? native_msm_straus(E, scalars, points)
+        : native_msm_pippenger(E, scalars, points);
+}
+
+// ============================================================================
+// DESCOMPRESION DE PUNTOS
+// ============================================================================
+
+/**
+ * @brief y con y^2 = x^3 + ax + b y la paridad pedida
+ *
+ * x debe estar en [0, p). false si x no es abscisa de ningun punto, o si
+ * y = 0 y se pide y impar.
+ */
+template<class Curve>
+bool native_decompress_y(const Curve& E, const BigInt& x, bool y_odd, BigInt& y) {
+    const auto& F = E.F;
+    typename Curve::Elem X = F.from_bigint(x);
+    typename Curve::Elem rhs = F.add(F.mul(F.add(F.sqr(X), E.a()), X), E.b());
+
+    typename Curve::Elem root;
+    if (!F.sqrt(rhs, root)) return false;
+
+    y = F.to_bigint(root);
+    if (IsOdd(y) != y_odd) {
+        if (IsZero(y)) return false;
+        y = F.modulus() - y;
+    }
+    return true;
+}
+
+} // namespace crypto
+
+#endif // ECC_NATIVE_HPP
@@ -0,0 +1,134 @@
+// ecdsa_presign.hpp
+// Firma ECDSA offline/online: reserva acotada de nonces precalculados
+// (k, r, k^-1) que se rellena en segundo plano
+//
+// Autor: Leon Elliott Fuller
+// Fecha: 2026-10-16
+
+#ifndef ECDSA_PRESIGN_HPP
+#define ECDSA_PRESIGN_HPP
+
+#include "common.hpp"
+#include "ecc.hpp"
+#include "rng.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace crypto {
+
+// ============================================================================
+// FIRMA OFFLINE/ONLINE
+// ============================================================================
+
+/**
+ * Por que separar la firma en dos fases
+ *
+ * En ECDSA todo lo caro depende solo del nonce k, no del mensaje ni de la
+ * clave:
+ *   offline:  k aleatorio, R = k*G, r = x(R) mod n, k^-1 mod n
+ *   online:   s = k^-1 * (z + r*d) mod n
+ * La fase offline (una multiplicacion escalar y una inversion modular) se
+ * puede adelantar; la online son dos multiplicaciones modulares. Cada
+ * tripleta se usa una sola vez: reutilizar k revela la clave privada.
+ */
+
+/**
+ * @brief Metricas de la reserva de nonces
+ */
+struct PresignStats {
+    size_t pool_size = 0;       // Tripletas disponibles ahora
+    size_t capacity = 0;        // Tamano maximo de la reserva
+    uint64_t produced = 0;      // Tripletas precalculadas en total
+    uint64_t served = 0;        // Firmas servidas desde la reserva
+    uint64_t exhausted = 0;     // Firmas con la reserva vacia (fase offline en linea)
+    uint64_t worker_errors = 0; // Excepciones del hilo de recarga (0 o 1: deja de rellenar)
+    double refill_per_sec = 0;  // Tripletas por segundo de trabajo de recarga
+};
+
+/**
+ * @brief Firmante ECDSA con nonces precalculados
+ *
+ * La reserva guarda hasta capacity tripletas (k^-1, r, recovery_id). Con
+ * background = true un hilo la rellena en lotes de REFILL_BATCH (k*G con
+ * la tabla de base fija, una inversion de campo para normalizar el lote y
+ * una inversion modulo n para todos los k) cada vez que baja de la mitad.
+ * Si una firma encuentra la reserva vacia no espera: calcula su tripleta
+ * en linea y lo cuenta en PresignStats::exhausted. Si el hilo de recarga
+ * recibe una excepcion (RNG, bad_alloc) no termina el proceso: la cuenta
+ * en PresignStats::worker_errors y deja de rellenar, y las firmas siguen
+ * por el camino en linea.
+ *
+ * El hilo de recarga no comparte el RNG: usa un NTLRNG propio sembrado con
+ * 256 bits del RNG recibido (el flujo aleatorio de NTL es por hilo).
+ *
+ * Es seguro llamar a sign/sign_hash desde varios hilos.
+ */
+class ECDSAPresigner {
+public:
+    static constexpr size_t REFILL_BATCH = 64;
+
+    /**
+     * @param curve Curva (debe vivir mas que el firmante)
+     * @param rng Fuente de los nonces; pasa a ser propiedad del firmante
+     * @param capacity Tripletas maximas en la reserva
+     * @param background Rellenar con un hilo propio (si no, usar refill())
+     * @throws std::invalid_argument si capacity es 0 o rng es nulo
+     */
+    ECDSAPresigner(const CurveParams& curve, std::unique_ptr<RNG> rng,
+                   size_t capacity = 1024, bool background = true);
+    ~ECDSAPresigner();
+
+    ECDSAPresigner(const ECDSAPresigner&) = delete;
+    ECDSAPresigner& operator=(const ECDSAPresigner&) = delete;
+
+    /**
+     * @brief Firma un hash consumiendo una tripleta de la reserva
+     *
+     * Misma firma (r, s, recovery_id) que ecdsa_sign_hash con ese nonce.
+     * @throws std::invalid_argument si la clave no esta en [1, n-1]
+     */
+    ECDSASignature sign_hash(const BigInt& hash_value, const BigInt& private_key);
+
+    /** @brief SHA-256 del mensaje y sign_hash */
+    ECDSASignature sign(const std::string& message, const BigInt& private_key);
+
+    /** @brief Rellena la reserva hasta capacity en el hilo que llama */
+    void refill();
+
+    PresignStats stats() const;
+
+private:
+    struct Presig {
+        BigInt k_inv;
+        BigInt r;
+        int recovery_id;
+    };
+
+    std::vector<Presig> produce(RNG& rng, size_t count);
+    void push(std::vector<Presig>&& batch, uint64_t elapsed_us);
+    void worker(BigInt seed);
+
+    const CurveParams& curve_;
+    std::unique_ptr<RNG> rng_;
+    std::mutex rng_mutex_;              // RNG no es seguro entre hilos
+    size_t capacity_;
+
+    mutable std::mutex mutex_;          // Protege pool_ y las metricas
+    std::condition_variable cv_;
+    std::vector<Presig> pool_;
+    bool stop_ = false;
+    PresignStats stats_;
+    uint64_t refill_us_ = 0;
+
+    std::thread thread_;                // Se arranca al final del constructor
+};
+
+} // namespace crypto
+
+#endif // ECDSA_PRESIGN_HPP
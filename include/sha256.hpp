@@ -138,6 +138,23 @@ public:
      * @return BigInt representando el hash
      */
     static BigInt hash_to_bigint(const std::string& message);
+    
+    /**
+     * @brief HMAC-SHA256 (RFC 2104 / FIPS 198-1)
+     * 
+     * HMAC(K, m) = H((K0 ^ opad) || H((K0 ^ ipad) || m)), donde K0 es la
+     * clave rellenada con ceros hasta 64 bytes (o su hash si es mas larga).
+     * Lo usa la generacion determinista de nonces de RFC 6979.
+     * 
+     * @param key Clave (cualquier longitud)
+     * @param data Mensaje
+     * @param length Longitud del mensaje en bytes
+     * @return Etiqueta de 256 bits
+     */
+    static SHA256Digest hmac(const std::vector<uint8_t>& key,
+                             const uint8_t* data, size_t length);
+    static SHA256Digest hmac(const std::vector<uint8_t>& key,
+                             const std::vector<uint8_t>& data);
 
 private:
     // ========================================================================
@@ -49,7 +49,7 @@ else
 fi
 
 # Lista de fuentes (coincide con SOURCES del Makefile, incluye ecc_binary.cpp)
-SRC_FILES="$SRC_DIR/rng.cpp $SRC_DIR/rsa.cpp $SRC_DIR/ecc.cpp $SRC_DIR/ecc_binary.cpp $SRC_DIR/sha256.cpp $SRC_DIR/main.cpp"
+SRC_FILES="$SRC_DIR/rng.cpp $SRC_DIR/rsa.cpp $SRC_DIR/ecc_field.cpp $SRC_DIR/ecc.cpp $SRC_DIR/ecdsa_presign.cpp $SRC_DIR/ecc_binary.cpp $SRC_DIR/sha256.cpp $SRC_DIR/main.cpp"
 
 # Conjuntos de flags a comparar (etiqueta:flags)
 declare -a FLAG_SETS=(
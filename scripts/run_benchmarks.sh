@@ -14,7 +14,7 @@ ITERATIONS=${1:-10}
 SEED_MODE="fixed"
 RESULTS_DIR="results"
 BIN="./bin/bench"
-SRC_FILES="main.cpp rng.cpp rsa.cpp ecc.cpp ecc_binary.cpp sha256.cpp"
+SRC_FILES="main.cpp rng.cpp rsa.cpp ecc_field.cpp ecc.cpp ecdsa_presign.cpp ecc_binary.cpp sha256.cpp"
 CXX_FLAGS="-std=c++17 -O2"
 LIBS="-lntl -lgmp -lpthread"
 
@@ -6,13 +6,39 @@
 // Fecha: 2026-03-02
 
 #include "ecc.hpp"
+#include "ecc_native.hpp"
 #include "sha256.hpp"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <stdexcept>
+#include <atomic>
+#include <type_traits>
 
 namespace crypto {
 
+// ============================================================================
+// PRECALCULOS POR CURVA
+// ============================================================================
+
+// CurveCache esta definida en ecc_native.hpp
+
+const CurveCache& CurveParams::cache() const {
+    // Publicacion atomica: si dos hilos construyen a la vez, gana uno y
+    // el otro descarta su copia
+    std::shared_ptr<const CurveCache> current = std::atomic_load(&cache_);
+    if (!current) {
+        auto fresh = std::make_shared<const CurveCache>(*this);
+        if (std::atomic_compare_exchange_strong(&cache_, &current, fresh)) {
+            current = fresh;
+        }
+    }
+    return *current;
+}
+
+CurveFieldScope::CurveFieldScope(const CurveParams& curve)
+    : push_(curve.cache().zzp) {}
+
 // ============================================================================
 // PARAMETROS DE CURVAS ESTANDAR
 // ============================================================================
@@ -99,7 +125,7 @@ bool CurveParams::validate() const {
     if (p <= 3) return false;
     
     // Verificar discriminante: 4a^3 + 27b^2 != 0 (mod p)
-    ZZ_p::init(p);
+    CurveFieldScope scope(*this);
     ZZ_p a_p = conv<ZZ_p>(a);
     ZZ_p b_p = conv<ZZ_p>(b);
     
@@ -148,21 +174,31 @@ ECPoint::ECPoint(const CurveParams* curve)
 }
 
 ECPoint::ECPoint(const BigInt& x, const BigInt& y, const CurveParams* curve)
-    : x_(x), y_(y), is_infinity_(false), curve_(curve) {
-    if (!curve_) {
-        throw std::invalid_argument("Curve parameters cannot be null");
+    : ECPoint(x, y, curve, TrustedTag()) {
+    if (x_ < 0 || x_ >= curve_->p || y_ < 0 || y_ >= curve_->p) {
+        throw std::invalid_argument("Point coordinates must be in range [0, p-1]");
     }
-    
     if (!is_on_curve()) {
         throw std::invalid_argument("Point is not on the curve");
     }
 }
 
+ECPoint::ECPoint(const BigInt& x, const BigInt& y, const CurveParams* curve, TrustedTag)
+    : x_(x), y_(y), is_infinity_(false), curve_(curve) {
+    if (!curve_) {
+        throw std::invalid_argument("Curve parameters cannot be null");
+    }
+}
+
+ECPoint ECPoint::trusted(const BigInt& x, const BigInt& y, const CurveParams* curve) {
+    return ECPoint(x, y, curve, TrustedTag());
+}
+
 bool ECPoint::is_on_curve() const {
     if (is_infinity_) return true;
     
     // Verificar: y^2 = x^3 + ax + b (mod p)
-    ZZ_p::init(curve_->p);
+    CurveFieldScope scope(*curve_);
     
     ZZ_p x_p = conv<ZZ_p>(x_);
     ZZ_p y_p = conv<ZZ_p>(y_);
@@ -244,7 +280,7 @@ ECPoint ec_add(const ECPoint& P, const ECPoint& Q) {
         return ec_double(P);
     }
     
-    ZZ_p::init(curve->p);
+    CurveFieldScope scope(*curve);
     
     ZZ_p x1 = conv<ZZ_p>(P.x());
     ZZ_p y1 = conv<ZZ_p>(P.y());
@@ -257,7 +293,7 @@ ECPoint ec_add(const ECPoint& P, const ECPoint& Q) {
     ZZ_p x3 = power(lambda, 2) - x1 - x2;
     ZZ_p y3 = lambda * (x1 - x3) - y1;
     
-    return ECPoint(conv<BigInt>(x3), conv<BigInt>(y3), curve);
+    return ECPoint::trusted(conv<BigInt>(x3), conv<BigInt>(y3), curve);
 }
 
 ECPoint ec_double(const ECPoint& P) {
@@ -269,7 +305,7 @@ ECPoint ec_double(const ECPoint& P) {
         return ECPoint(curve);
     }
     
-    ZZ_p::init(curve->p);
+    CurveFieldScope scope(*curve);
     
     ZZ_p x = conv<ZZ_p>(P.x());
     ZZ_p y = conv<ZZ_p>(P.y());
@@ -281,7 +317,7 @@ ECPoint ec_double(const ECPoint& P) {
     ZZ_p x3 = power(lambda, 2) - 2 * x;
     ZZ_p y3 = lambda * (x - x3) - y;
     
-    return ECPoint(conv<BigInt>(x3), conv<BigInt>(y3), curve);
+    return ECPoint::trusted(conv<BigInt>(x3), conv<BigInt>(y3), curve);
 }
 
 ECPoint ec_negate(const ECPoint& P) {
@@ -290,7 +326,7 @@ ECPoint ec_negate(const ECPoint& P) {
     const CurveParams* curve = P.curve();
     BigInt neg_y = (curve->p - P.y()) % curve->p;
     
-    return ECPoint(P.x(), neg_y, curve);
+    return ECPoint::trusted(P.x(), neg_y, curve);
 }
 
 ECPoint ec_scalar_mult(const BigInt& k, const ECPoint& P) {
@@ -337,7 +373,7 @@ ECPoint to_affine(const JacobianPoint& J) {
     
     // Esta es la UNICA inversion necesaria en toda la multiplicacion escalar
     // x = X * Z^(-2), y = Y * Z^(-3)
-    ZZ_p::init(curve->p);
+    CurveFieldScope scope(*curve);
     
     ZZ_p Z_inv = inv(conv<ZZ_p>(J.Z()));
     ZZ_p Z_inv2 = power(Z_inv, 2);    // Z^(-2)
@@ -346,7 +382,33 @@ ECPoint to_affine(const JacobianPoint& J) {
     ZZ_p x = conv<ZZ_p>(J.X()) * Z_inv2;
     ZZ_p y = conv<ZZ_p>(J.Y()) * Z_inv3;
     
-    return ECPoint(conv<BigInt>(x), conv<BigInt>(y), curve);
+    return ECPoint::trusted(conv<BigInt>(x), conv<BigInt>(y), curve);
+}
+
+std::vector<ECPoint> to_affine_batch(const std::vector<JacobianPoint>& points) {
+    if (points.empty()) return {};
+    
+    const CurveParams* curve = points[0].curve();
+    for (const auto& J : points) {
+        if (J.curve() != curve) {
+            throw std::invalid_argument("Points must be on the same curve");
+        }
+    }
+    
+    return with_native_curve(*curve, [&](const auto& E) {
+        using Point = typename std::decay<decltype(E)>::type::Point;
+        std::vector<Point> native;
+        native.reserve(points.size());
+        for (const auto& J : points) {
+            if (J.is_infinity()) {
+                native.push_back(E.infinity());
+            } else {
+                native.push_back(Point{E.F.from_bigint(J.X()), E.F.from_bigint(J.Y()),
+                                       E.F.from_bigint(J.Z())});
+            }
+        }
+        return native_to_affine_batch(E, std::move(native));
+    });
 }
 
 /**
@@ -383,7 +445,7 @@ JacobianPoint jacobian_add(const JacobianPoint& P, const JacobianPoint& Q) {
     if (P.is_infinity()) return Q;
     if (Q.is_infinity()) return P;
     
-    ZZ_p::init(curve->p);
+    CurveFieldScope scope(*curve);
     
     ZZ_p X1 = conv<ZZ_p>(P.X());
     ZZ_p Y1 = conv<ZZ_p>(P.Y());
@@ -448,14 +510,17 @@ JacobianPoint jacobian_add(const JacobianPoint& P, const JacobianPoint& Q) {
  * Coste total: 4M + 4S (0 inversiones)
  * 
  * Nota: para secp256k1 donde a=0, D se simplifica a 3*X1^2 (ahorro extra).
- * Para NIST P-256 donde a=-3, D = 3*(X1-Z1^2)*(X1+Z1^2) (optimizable).
+ * Para NIST P-256 donde a=-3, D = 3*(X1-Z1^2)*(X1+Z1^2).
+ * Ambas variantes estan en NativeCurve::dbl (ecc_native.hpp), que es la
+ * que usan las multiplicaciones escalares; esta version queda como
+ * referencia con BigInt.
  */
 JacobianPoint jacobian_double(const JacobianPoint& P) {
     if (P.is_infinity()) return P;
     
     const CurveParams* curve = P.curve();
     
-    ZZ_p::init(curve->p);
+    CurveFieldScope scope(*curve);
     
     ZZ_p X1 = conv<ZZ_p>(P.X());
     ZZ_p Y1 = conv<ZZ_p>(P.Y());
@@ -489,6 +554,24 @@ JacobianPoint jacobian_double(const JacobianPoint& P) {
                          conv<BigInt>(Z3), curve);
 }
 
+namespace {
+
+void check_wnaf_width(int w) {
+    if (w < 2 || w > 7) {
+        throw std::invalid_argument("wNAF width must be between 2 and 7");
+    }
+}
+
+// Solo importa si la curva usa WNAF o GLV (que usa wNAF por dentro)
+void check_wnaf_width(const CurveParams& curve) {
+    if (curve.scalar_method == ScalarMethod::LADDER ||
+        curve.scalar_method == ScalarMethod::COMPLETE) return;
+    bool glv = curve.use_endomorphism && curve.cache().glv;
+    if (curve.scalar_method == ScalarMethod::WNAF || glv) check_wnaf_width(curve.wnaf_width);
+}
+
+} // namespace
+
 /**
  * Multiplicacion escalar usando coordenadas Jacobianas
  * 
@@ -497,6 +580,10 @@ JacobianPoint jacobian_double(const JacobianPoint& P) {
  * 2. Ejecutar double-and-add enteramente en Jacobianas
  * 3. Convertir resultado final a afin (UNA sola inversion)
  * 
+ * Los pasos 1-3 usan NativeJacobian (ecc_native.hpp): las coordenadas son
+ * ZZ_p o FpElem<N> durante todo el bucle, sin conv<ZZ_p>/conv<BigInt> en
+ * cada suma o doblado como en jacobian_add/jacobian_double.
+ * 
  * Para k de 256 bits:
  * - ~256 doblados Jacobianos (4M + 4S cada uno)
  * - ~128 sumas Jacobianas (12M + 4S cada una)
@@ -515,24 +602,375 @@ ECPoint ec_scalar_mult_jacobian(const BigInt& k, const ECPoint& P) {
     }
     
     const CurveParams* curve = P.curve();
+    check_wnaf_width(*curve);
+    BigInt k_red = k % curve->n;
+    
+    // Las coordenadas se quedan en el campo (ZZ_p o limbs de tamano fijo)
+    // durante todo el bucle; solo P entra y el resultado sale como BigInt
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_scalar_mult_method(E, k_red, E.from_affine(P)));
+    });
+}
+
+// ============================================================================
+// MULTIPLICACION ESCALAR wNAF
+// ============================================================================
+
+/**
+ * Recodificacion por ventanas deslizantes sobre los bits de k:
+ * - Si el bit actual (mas el acarreo pendiente) es 0, el digito es 0.
+ * - Si no, se toman w bits: v = bits + acarreo. Si v >= 2^(w-1) el digito
+ *   es v - 2^w (negativo) y se propaga un acarreo de 1; los w-1 digitos
+ *   siguientes son 0.
+ * El vector tiene NumBits(k) + 1 digitos como mucho.
+ */
+std::vector<int> wnaf_recode(const BigInt& k, int w) {
+    long len = NumBits(k) + 1;
+    std::vector<int> naf(len, 0);
+    
+    int carry = 0;
+    long i = 0;
+    while (i < len) {
+        if (bit(k, i) == carry) {
+            i++;
+            continue;
+        }
+        int v = carry;
+        for (int j = 0; j < w; j++) {
+            v += (int)bit(k, i + j) << j;   // bit() devuelve 0 fuera de rango
+        }
+        carry = (v >> (w - 1)) & 1;
+        naf[i] = v - (carry << w);
+        i += w;
+    }
     
-    // Paso 1: Convertir a Jacobiano
-    JacobianPoint result(curve);  // Infinito
-    JacobianPoint addend = to_jacobian(P);
+    while (!naf.empty() && naf.back() == 0) naf.pop_back();
+    return naf;
+}
+
+ECPoint ec_scalar_mult_wnaf(const BigInt& k, const ECPoint& P, int w) {
+    check_wnaf_width(w);
+    if (k == 0 || P.is_infinity()) {
+        return ECPoint(P.curve());
+    }
     
-    BigInt k_copy = k % curve->n;
+    const CurveParams* curve = P.curve();
+    BigInt k_red = k % curve->n;
     
-    // Paso 2: Double-and-add en Jacobiano (sin inversiones)
-    while (k_copy > 0) {
-        if (k_copy % 2 == 1) {
-            result = jacobian_add(result, addend);
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_scalar_mult_wnaf(E, k_red, E.from_affine(P), w));
+    });
+}
+
+// ============================================================================
+// ESCALERA DE MONTGOMERY
+// ============================================================================
+
+ECPoint ec_scalar_mult_ladder(const BigInt& k, const ECPoint& P) {
+    const CurveParams* curve = P.curve();
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_scalar_mult_ladder(E, k, E.from_affine(P)));
+    });
+}
+
+// ============================================================================
+// FORMULAS COMPLETAS
+// ============================================================================
+
+ECPoint ec_scalar_mult_complete(const BigInt& k, const ECPoint& P) {
+    const CurveParams* curve = P.curve();
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_scalar_mult_complete(E, k, E.from_affine(P)));
+    });
+}
+
+// ============================================================================
+// MULTIPLICACION DE BASE FIJA (GENERADOR)
+// ============================================================================
+
+ECPoint ec_generator_mult(const BigInt& k, const CurveParams& curve) {
+    BigInt k_red = k % curve.n;
+    if (k_red == 0) return ECPoint(&curve);
+    
+    return with_native_curve(curve, [&](const auto& E) {
+        return E.to_affine(native_generator_mult_method(E, k_red));
+    });
+}
+
+// ============================================================================
+// ENDOMORFISMO GLV (secp256k1)
+// ============================================================================
+
+std::unique_ptr<const GlvParams> glv_params_for(const CurveParams& curve) {
+    // secp256k1 (SEC 2, 2.4.1). Base del reticulo tomada de libsecp256k1
+    // (Gallant-Lambert-Vanstone, 2001; Guide to ECC, Alg. 3.74)
+    static const BigInt K1_P = power2_ZZ(256) - power2_ZZ(32) - 977;
+    if (curve.p != K1_P || !IsZero(curve.a % curve.p)) return nullptr;
+    
+    auto glv = std::unique_ptr<GlvParams>(new GlvParams);
+    conv(glv->beta,   "55594575648329892869085402983802832744385952214688224221778511981742606582254");
+    conv(glv->lambda, "37718080363155996902926221483475020450927657555482586988616620542887997980018");
+    conv(glv->a1,     "64502973549206556628585045361533709077");
+    conv(glv->b1,     "-303414439467246543595250775667605759171");
+    conv(glv->a2,     "367917413016453100223835821029139468248");
+    glv->b2     = glv->a1;
+    
+    // Las constantes solo valen para el orden de secp256k1
+    if ((glv->a1 + glv->b1 * glv->lambda) % curve.n != 0 ||
+        (glv->a2 + glv->b2 * glv->lambda) % curve.n != 0) {
+        return nullptr;
+    }
+    return std::unique_ptr<const GlvParams>(glv.release());
+}
+
+void glv_split(const GlvParams& glv, const BigInt& n, const BigInt& k,
+               BigInt& k1, BigInt& k2) {
+    // Redondeo a entero mas cercano de un cociente no negativo: (x + n/2) / n
+    BigInt half = n / 2;
+    BigInt c1 = (glv.b2 * k + half) / n;
+    BigInt c2 = (-glv.b1 * k + half) / n;
+    
+    k1 = k - c1 * glv.a1 - c2 * glv.a2;
+    k2 = -c1 * glv.b1 - c2 * glv.b2;
+}
+
+ECPoint ec_scalar_mult_glv(const BigInt& k, const ECPoint& P) {
+    const CurveParams* curve = P.curve();
+    const GlvParams* glv = curve->cache().glv.get();
+    if (!glv) {
+        throw std::invalid_argument("Curve has no GLV endomorphism");
+    }
+    check_wnaf_width(curve->wnaf_width);
+    if (P.is_infinity()) return P;
+    
+    BigInt k_red = k % curve->n;
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_scalar_mult_glv(E, *glv, k_red, E.from_affine(P),
+                                                  curve->wnaf_width));
+    });
+}
+
+// ============================================================================
+// MULTIPLICACION MULTIESCALAR
+// ============================================================================
+
+std::vector<int> signed_window_recode(const BigInt& k, int c, long digits) {
+    std::vector<int> out(digits, 0);
+    int carry = 0;
+    for (long i = 0; i < digits; i++) {
+        int v = carry;
+        for (int j = 0; j < c; j++) {
+            v += (int)bit(k, i * c + j) << j;
         }
-        addend = jacobian_double(addend);
-        k_copy /= 2;
+        carry = (v > (1 << (c - 1))) ? 1 : 0;
+        out[i] = v - (carry << c);
+    }
+    return out;
+}
+
+ECPoint ec_multi_scalar_mult(const std::vector<BigInt>& scalars,
+                             const std::vector<ECPoint>& points,
+                             MultiScalarMethod method) {
+    if (scalars.size() != points.size()) {
+        throw std::invalid_argument("Multi-scalar mult: scalar and point counts differ");
+    }
+    if (points.empty()) {
+        throw std::invalid_argument("Multi-scalar mult: no terms");
+    }
+    
+    const CurveParams* curve = points[0].curve();
+    for (const auto& P : points) {
+        if (P.curve() != curve) {
+            throw std::invalid_argument("Points must be on the same curve");
+        }
+    }
+    
+    return with_native_curve(*curve, [&](const auto& E) {
+        using Point = typename std::decay<decltype(E)>::type::Point;
+        std::vector<BigInt> ks;
+        std::vector<Point> ps;
+        ks.reserve(points.size());
+        ps.reserve(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            BigInt k = scalars[i] % curve->n;
+            if (IsZero(k) || points[i].is_infinity()) continue;
+            ks.push_back(k);
+            ps.push_back(E.from_affine(points[i]));
+        }
+        if (ps.empty()) return ECPoint(curve);
+        return E.to_affine(native_multi_scalar_mult(E, std::move(ks), std::move(ps), method));
+    });
+}
+
+// ============================================================================
+// MULTIPLICACION DOBLE (STRAUSS-SHAMIR)
+// ============================================================================
+
+ECPoint ec_double_scalar_mult(const BigInt& a, const ECPoint& P,
+                              const BigInt& b, const ECPoint& Q, int w) {
+    if (P.curve() != Q.curve()) {
+        throw std::invalid_argument("Points must be on the same curve");
     }
+    check_wnaf_width(w);
     
-    // Paso 3: Convertir resultado a afin (UNA inversion)
-    return to_affine(result);
+    const CurveParams* curve = P.curve();
+    BigInt a_red = a % curve->n;
+    BigInt b_red = b % curve->n;
+    
+    return with_native_curve(*curve, [&](const auto& E) {
+        auto p_odd = native_odd_multiples(E, E.from_affine(P), size_t(1) << (w - 2));
+        auto q_odd = native_odd_multiples(E, E.from_affine(Q), size_t(1) << (w - 2));
+        return E.to_affine(native_interleaved_wnaf(E,
+            {wnaf_recode(a_red, w), wnaf_recode(b_red, w)}, {&p_odd, &q_odd}));
+    });
+}
+
+ECPoint ec_generator_mult_add(const BigInt& u1, const BigInt& u2, const ECPoint& Q) {
+    const CurveParams* curve = Q.curve();
+    check_wnaf_width(curve->wnaf_width);
+    BigInt u1_red = u1 % curve->n;
+    BigInt u2_red = u2 % curve->n;
+    
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_generator_mult_add_key(E, u1_red, u2_red, Q));
+    });
+}
+
+// ============================================================================
+// CODIFICACION DE PUNTOS (SEC1)
+// ============================================================================
+
+namespace {
+
+// x como len bytes big-endian (SEC1 FE2OSP, RFC 6979 int2octets);
+// BytesFromZZ es little-endian
+std::vector<uint8_t> int_to_octets(const BigInt& x, long len) {
+    std::vector<uint8_t> le(len);
+    BytesFromZZ(le.data(), x, len);
+    return std::vector<uint8_t>(le.rbegin(), le.rend());
+}
+
+BigInt octets_to_int(const uint8_t* data, size_t length) {
+    std::vector<uint8_t> le(data, data + length);
+    std::reverse(le.begin(), le.end());
+    return ZZFromBytes(le.data(), (long)length);
+}
+
+/**
+ * Decodifica una entrada con el backend ya elegido: las entradas
+ * comprimidas no pasan por is_on_curve (la raiz ya lo garantiza)
+ */
+template<class Curve>
+ECPoint decode_point(const Curve& E, const std::vector<uint8_t>& data) {
+    const CurveParams& curve = *E.curve();
+    size_t len = (size_t)NumBytes(curve.p);
+    
+    if (data.size() == 1 && data[0] == 0x00) return ECPoint(&curve);
+    if (data.empty()) {
+        throw std::invalid_argument("SEC1: empty encoding");
+    }
+    
+    uint8_t prefix = data[0];
+    if (prefix == 0x02 || prefix == 0x03) {
+        if (data.size() != 1 + len) {
+            throw std::invalid_argument("SEC1: bad compressed point length");
+        }
+        BigInt x = octets_to_int(data.data() + 1, len);
+        BigInt y;
+        if (x >= curve.p || !native_decompress_y(E, x, prefix == 0x03, y)) {
+            throw std::invalid_argument("SEC1: x is not the abscissa of a curve point");
+        }
+        return ECPoint::trusted(x, y, &curve);
+    }
+    if (prefix == 0x04) {
+        if (data.size() != 1 + 2 * len) {
+            throw std::invalid_argument("SEC1: bad uncompressed point length");
+        }
+        return ECPoint(octets_to_int(data.data() + 1, len),
+                       octets_to_int(data.data() + 1 + len, len), &curve);
+    }
+    throw std::invalid_argument("SEC1: unsupported point prefix");
+}
+
+} // namespace
+
+bool ec_field_sqrt(const BigInt& a, const CurveParams& curve, BigInt& root) {
+    return with_native_curve(curve, [&](const auto& E) {
+        typename std::decay<decltype(E)>::type::Elem r;
+        if (!E.F.sqrt(E.F.from_bigint(a), r)) return false;
+        root = E.F.to_bigint(r);
+        return true;
+    });
+}
+
+std::vector<uint8_t> ec_point_encode(const ECPoint& P, bool compressed) {
+    if (P.is_infinity()) return {0x00};
+    
+    long len = NumBytes(P.curve()->p);
+    std::vector<uint8_t> out;
+    out.reserve(1 + (compressed ? 1 : 2) * len);
+    out.push_back(compressed ? (IsOdd(P.y()) ? 0x03 : 0x02) : 0x04);
+    
+    std::vector<uint8_t> x = int_to_octets(P.x(), len);
+    out.insert(out.end(), x.begin(), x.end());
+    if (!compressed) {
+        std::vector<uint8_t> y = int_to_octets(P.y(), len);
+        out.insert(out.end(), y.begin(), y.end());
+    }
+    return out;
+}
+
+ECPoint ec_point_decode(const std::vector<uint8_t>& data, const CurveParams& curve) {
+    return with_native_curve(curve, [&](const auto& E) {
+        return decode_point(E, data);
+    });
+}
+
+std::vector<ECPoint> ec_point_decode_batch(const std::vector<std::vector<uint8_t>>& data,
+                                           const CurveParams& curve) {
+    return with_native_curve(curve, [&](const auto& E) {
+        std::vector<ECPoint> out;
+        out.reserve(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            try {
+                out.push_back(decode_point(E, data[i]));
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument("Entry " + std::to_string(i) + ": " + e.what());
+            }
+        }
+        return out;
+    });
+}
+
+// ============================================================================
+// CACHE DE TABLAS POR CLAVE PUBLICA
+// ============================================================================
+
+std::string point_cache_key(const ECPoint& Q) {
+    std::vector<uint8_t> enc = ec_point_encode(Q, false);
+    return std::string(enc.begin(), enc.end());
+}
+
+KeyCacheStats ec_key_cache_stats(const CurveParams& curve) {
+    const CurveCache& cache = curve.cache();
+    KeyCacheStats total;
+    for (const KeyCacheStats& s : {cache.k_ntl.stats(), cache.k_f4.stats(), cache.k_f6.stats()}) {
+        total.hits += s.hits;
+        total.misses += s.misses;
+        total.builds += s.builds;
+        total.evictions += s.evictions;
+        total.entries += s.entries;
+        total.tables += s.tables;
+        total.bytes += s.bytes;
+    }
+    return total;
+}
+
+void ec_key_cache_clear(const CurveParams& curve) {
+    const CurveCache& cache = curve.cache();
+    cache.k_ntl.clear();
+    cache.k_f4.clear();
+    cache.k_f6.clear();
 }
 
 // ============================================================================
@@ -543,14 +981,40 @@ ECKeyPair generate_keypair(const CurveParams& curve, RNG& rng,
                            bool use_jacobian) {
     BigInt private_key = rng.random_range(to_ZZ(1), curve.n - 1);
     
-    ECPoint G(curve.Gx, curve.Gy, &curve);
-    ECPoint public_key = use_jacobian 
-        ? ec_scalar_mult_jacobian(private_key, G)
-        : ec_scalar_mult(private_key, G);
+    // Jacobianas: tabla de base fija de G (cacheada en la curva)
+    ECPoint public_key = use_jacobian
+        ? ec_generator_mult(private_key, curve)
+        : ec_scalar_mult(private_key, ECPoint::trusted(curve.Gx, curve.Gy, &curve));
     
     return ECKeyPair{private_key, public_key, &curve};
 }
 
+std::vector<ECKeyPair> generate_keypair_batch(const CurveParams& curve, RNG& rng,
+                                              size_t count) {
+    std::vector<BigInt> private_keys;
+    private_keys.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        private_keys.push_back(rng.random_range(to_ZZ(1), curve.n - 1));
+    }
+    
+    std::vector<ECPoint> public_keys = with_native_curve(curve, [&](const auto& E) {
+        using Point = typename std::decay<decltype(E)>::type::Point;
+        std::vector<Point> points;
+        points.reserve(count);
+        for (const auto& d : private_keys) {
+            points.push_back(native_generator_mult_method(E, d));
+        }
+        return native_to_affine_batch(E, std::move(points));
+    });
+    
+    std::vector<ECKeyPair> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        keys.push_back(ECKeyPair{private_keys[i], public_keys[i], &curve});
+    }
+    return keys;
+}
+
 void ECKeyPair::print(bool show_private) const {
     std::cout << "\n" << std::string(70, '=') << "\n";
     std::cout << "PAR DE CLAVES ECC\n";
@@ -575,9 +1039,43 @@ void ECKeyPair::print(bool show_private) const {
 ECPoint ecdh_shared_secret(const BigInt& private_key, 
                            const ECPoint& public_key,
                            bool use_jacobian) {
-    return use_jacobian
-        ? ec_scalar_mult_jacobian(private_key, public_key)
-        : ec_scalar_mult(private_key, public_key);
+    const CurveParams* curve = public_key.curve();
+    if (!use_jacobian) return ec_scalar_mult(private_key, public_key);
+    if (curve->key_cache_bytes == 0) return ec_scalar_mult_jacobian(private_key, public_key);
+    
+    // Con la cache de claves: Q caliente => tabla de base fija de Q
+    BigInt k = private_key % curve->n;
+    if (k == 0 || public_key.is_infinity()) return ECPoint(curve);
+    check_wnaf_width(*curve);
+    return with_native_curve(*curve, [&](const auto& E) {
+        return E.to_affine(native_key_mult(E, k, public_key));
+    });
+}
+
+std::vector<ECPoint> ecdh_shared_secret_batch(const std::vector<BigInt>& private_keys,
+                                              const std::vector<ECPoint>& public_keys) {
+    if (private_keys.size() != public_keys.size()) {
+        throw std::invalid_argument("ECDH batch: key vectors must have the same size");
+    }
+    if (public_keys.empty()) return {};
+    
+    const CurveParams* curve = public_keys[0].curve();
+    for (const auto& Q : public_keys) {
+        if (Q.curve() != curve) {
+            throw std::invalid_argument("Points must be on the same curve");
+        }
+    }
+    check_wnaf_width(*curve);
+    
+    return with_native_curve(*curve, [&](const auto& E) {
+        using Point = typename std::decay<decltype(E)>::type::Point;
+        std::vector<Point> points;
+        points.reserve(public_keys.size());
+        for (size_t i = 0; i < public_keys.size(); i++) {
+            points.push_back(native_key_mult(E, private_keys[i] % curve->n, public_keys[i]));
+        }
+        return native_to_affine_batch(E, std::move(points));
+    });
 }
 
 BigInt ecdh_derive_key(const ECPoint& shared_point, int key_bits) {
@@ -619,26 +1117,104 @@ BigInt truncate_hash(const BigInt& hash, const BigInt& n) {
     return hash;
 }
 
-ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
+namespace {
+
+// ============================================================================
+// RFC 6979 - NONCES DETERMINISTAS (HMAC-SHA256)
+// ============================================================================
+
+/**
+ * Generador HMAC_DRBG de RFC 6979, Seccion 3.2
+ *
+ * El estado (K, V) depende solo de la clave privada y del hash, asi que
+ * la misma firma se repite byte a byte en cualquier ejecucion o hilo.
+ * next() continua la secuencia (paso h.3) si r o s salen 0.
+ */
+class RFC6979Nonces {
+public:
+    RFC6979Nonces(const BigInt& hash_value, const BigInt& private_key, const BigInt& n)
+        : n_(n), qlen_(NumBits(n)), rlen_((qlen_ + 7) / 8), K_(32, 0x00), V_(32, 0x01) {
+        // bits2octets(h1) = int2octets(bits2int(h1) mod q); el hash ocupa
+        // al menos los 256 bits del digest SHA-256
+        long hlen = std::max<long>(256, 8 * ((NumBits(hash_value) + 7) / 8));
+        BigInt z1 = bits_to_int(hash_value, hlen);
+
+        std::vector<uint8_t> seed = int_to_octets(private_key, rlen_);
+        std::vector<uint8_t> h1 = int_to_octets(z1 % n_, rlen_);
+        seed.insert(seed.end(), h1.begin(), h1.end());
+
+        reseed(0x00, seed);
+        reseed(0x01, seed);
+    }
+
+    BigInt next() {
+        for (;;) {
+            // T = V1 || V2 || ... hasta cubrir qlen bits
+            std::vector<uint8_t> T;
+            while ((long)T.size() * 8 < qlen_) {
+                V_ = mac(V_);
+                T.insert(T.end(), V_.begin(), V_.end());
+            }
+            BigInt k = bits_to_int(octets_to_int(T.data(), T.size()), 8 * (long)T.size());
+
+            // Paso h.3: se avanza el estado tanto si k se rechaza aqui como
+            // si luego da r = 0 o s = 0 y se vuelve a llamar a next()
+            reseed(0x00, {});
+            if (k >= 1 && k < n_) return k;
+        }
+    }
+
+private:
+    // bits2int: los qlen bits mas significativos de una cadena de blen bits
+    BigInt bits_to_int(const BigInt& x, long blen) const {
+        return (blen > qlen_) ? (x >> (blen - qlen_)) : x;
+    }
+
+    std::vector<uint8_t> mac(const std::vector<uint8_t>& data) const {
+        SHA256Digest d = SHA256::hmac(K_, data);
+        return std::vector<uint8_t>(d.bytes.begin(), d.bytes.end());
+    }
+
+    // K = HMAC_K(V || tag || extra); V = HMAC_K(V)
+    void reseed(uint8_t tag, const std::vector<uint8_t>& extra) {
+        std::vector<uint8_t> msg(V_);
+        msg.push_back(tag);
+        msg.insert(msg.end(), extra.begin(), extra.end());
+        K_ = mac(msg);
+        V_ = mac(V_);
+    }
+
+    BigInt n_;
+    long qlen_;
+    long rlen_;
+    std::vector<uint8_t> K_;
+    std::vector<uint8_t> V_;
+};
+
+/**
+ * Bucle comun de firma: next_nonce() entrega k en [1, n-1] y se repite
+ * mientras r o s sean 0
+ */
+template<typename NextNonce>
+ECDSASignature ecdsa_sign_with(const BigInt& hash_value,
                                const BigInt& private_key,
                                const CurveParams& curve,
-                               RNG& rng,
+                               NextNonce next_nonce,
                                bool use_jacobian) {
     if (private_key <= 0 || private_key >= curve.n) {
         throw std::invalid_argument("Private key must be in range [1, n-1]");
     }
     
-    ECPoint G(curve.Gx, curve.Gy, &curve);
     BigInt z = truncate_hash(hash_value, curve.n);
     
     ECDSASignature sig;
     
     while (true) {
-        BigInt k = rng.random_range(to_ZZ(1), curve.n - 1);
+        BigInt k = next_nonce();
         
         ECPoint kG = use_jacobian
-            ? ec_scalar_mult_jacobian(k, G)
-            : ec_scalar_mult(k, G);
+            ? ec_generator_mult(k, curve)
+            : ec_scalar_mult(k, ECPoint::trusted(curve.Gx, curve.Gy, &curve));
         
         if (kG.is_infinity()) continue;
         
@@ -649,12 +1225,38 @@ ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
         sig.s = (k_inv * ((z + sig.r * private_key) % curve.n)) % curve.n;
         
         if (sig.s == 0) continue;
+        sig.recovery_id = (IsOdd(kG.y()) ? 1 : 0) | (kG.x() >= curve.n ? 2 : 0);
         break;
     }
     
     return sig;
 }
 
+} // namespace
+
+ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
+                               const BigInt& private_key,
+                               const CurveParams& curve,
+                               RNG& rng,
+                               bool use_jacobian) {
+    return ecdsa_sign_with(hash_value, private_key, curve,
+        [&]() { return rng.random_range(to_ZZ(1), curve.n - 1); },
+        use_jacobian);
+}
+
+ECDSASignature ecdsa_sign_hash(const BigInt& hash_value,
+                               const BigInt& private_key,
+                               const CurveParams& curve,
+                               bool use_jacobian) {
+    // La validacion de la clave va antes de usarla como semilla
+    if (private_key <= 0 || private_key >= curve.n) {
+        throw std::invalid_argument("Private key must be in range [1, n-1]");
+    }
+    RFC6979Nonces nonces(hash_value, private_key, curve.n);
+    return ecdsa_sign_with(hash_value, private_key, curve,
+        [&]() { return nonces.next(); }, use_jacobian);
+}
+
 ECDSASignature ecdsa_sign(const std::string& message,
                           const BigInt& private_key,
                           const CurveParams& curve,
@@ -664,25 +1266,35 @@ ECDSASignature ecdsa_sign(const std::string& message,
     return ecdsa_sign_hash(hash_value, private_key, curve, rng, use_jacobian);
 }
 
+ECDSASignature ecdsa_sign(const std::string& message,
+                          const BigInt& private_key,
+                          const CurveParams& curve,
+                          bool use_jacobian) {
+    BigInt hash_value = SHA256::hash_to_bigint(message);
+    return ecdsa_sign_hash(hash_value, private_key, curve, use_jacobian);
+}
+
 bool ecdsa_verify_hash(const BigInt& hash_value,
                        const ECDSASignature& signature,
                        const ECPoint& public_key,
                        const CurveParams& curve,
                        bool use_jacobian) {
     if (!signature.is_valid_format(curve.n)) return false;
-    if (public_key.is_infinity() || !public_key.is_on_curve()) return false;
+    // La clave debe ser de esta curva: u1 y u2 se reducen modulo curve.n y
+    // ec_generator_mult_add toma G de public_key.curve()
+    if (public_key.is_infinity() || public_key.curve() != &curve ||
+        !public_key.is_on_curve()) return false;
     
     BigInt z = truncate_hash(hash_value, curve.n);
     BigInt w = InvMod(signature.s, curve.n);
     BigInt u1 = (z * w) % curve.n;
     BigInt u2 = (signature.r * w) % curve.n;
     
-    ECPoint G(curve.Gx, curve.Gy, &curve);
-    
-    ECPoint u1G = use_jacobian ? ec_scalar_mult_jacobian(u1, G) : ec_scalar_mult(u1, G);
-    ECPoint u2Q = use_jacobian ? ec_scalar_mult_jacobian(u2, public_key) : ec_scalar_mult(u2, public_key);
-    
-    ECPoint point = ec_add(u1G, u2Q);
+    // Jacobianas: u1*G + u2*Q con una sola cadena de doblados (Strauss-Shamir)
+    ECPoint point = use_jacobian
+        ? ec_generator_mult_add(u1, u2, public_key)
+        : ec_add(ec_scalar_mult(u1, ECPoint::trusted(curve.Gx, curve.Gy, &curve)),
+                 ec_scalar_mult(u2, public_key));
     
     if (point.is_infinity()) return false;
     
@@ -690,6 +1302,151 @@ bool ecdsa_verify_hash(const BigInt& hash_value,
     return v == signature.r;
 }
 
+// ============================================================================
+// ECDSA - VERIFICACION POR LOTES
+// ============================================================================
+
+namespace {
+
+/**
+ * Reconstruye R = (x, y) de una firma con recovery_id: x = r (+ n),
+ * y = sqrt(x^3 + ax + b) con la paridad indicada. false si no existe.
+ */
+template<class Curve>
+bool native_recover_r(const Curve& E, const ECDSASignature& sig, BigInt& x, BigInt& y) {
+    if (sig.recovery_id < 0 || sig.recovery_id > 3) return false;
+    
+    const CurveParams& curve = *E.curve();
+    x = sig.r + ((sig.recovery_id & 2) ? curve.n : BigInt(0));
+    if (x >= curve.p) return false;
+    
+    return native_decompress_y(E, x, (sig.recovery_id & 1) != 0, y);
+}
+
+bool recover_r_point(const ECDSASignature& sig, const CurveParams& curve, ECPoint& R) {
+    BigInt x, y;
+    bool ok = with_native_curve(curve, [&](const auto& E) {
+        return native_recover_r(E, sig, x, y);
+    });
+    if (!ok) return false;
+    
+    R = ECPoint::trusted(x, y, &curve);
+    return true;
+}
+
+/**
+ * Inversos modulo n de todos los valores (no nulos) con una sola InvMod
+ * (truco de Montgomery: productos prefijo y vuelta atras, 3 mul por valor)
+ */
+void batch_inv_mod(std::vector<BigInt>& values, const BigInt& n) {
+    if (values.empty()) return;
+    
+    std::vector<BigInt> prefix(values.size());
+    BigInt acc(1);
+    for (size_t i = 0; i < values.size(); i++) {
+        prefix[i] = acc;
+        acc = MulMod(acc, values[i], n);
+    }
+    BigInt inv = InvMod(acc, n);
+    for (size_t i = values.size(); i-- > 0;) {
+        BigInt v_inv = MulMod(inv, prefix[i], n);
+        inv = MulMod(inv, values[i], n);
+        values[i] = v_inv;
+    }
+}
+
+} // namespace
+
+std::vector<bool> ecdsa_verify_batch(const std::vector<BigInt>& hashes,
+                                     const std::vector<ECDSASignature>& signatures,
+                                     const std::vector<ECPoint>& public_keys,
+                                     const CurveParams& curve,
+                                     RNG& rng) {
+    size_t count = hashes.size();
+    if (signatures.size() != count || public_keys.size() != count) {
+        throw std::invalid_argument("ECDSA batch: input vectors must have the same size");
+    }
+    std::vector<bool> valid(count, false);
+    
+    // Agrupar claves iguales: cada clave distinta se valida una vez y
+    // aporta un solo termino a la suma
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const ECPoint& P = public_keys[a];
+        const ECPoint& Q = public_keys[b];
+        if (P.is_infinity() != Q.is_infinity()) return P.is_infinity();
+        if (P.x() != Q.x()) return P.x() < Q.x();
+        return P.y() < Q.y();
+    });
+    
+    std::vector<long> group(count, -1);
+    std::vector<size_t> group_key;          // Indice de una firma de cada grupo
+    std::vector<bool> group_ok;
+    for (size_t j = 0; j < count; j++) {
+        size_t i = order[j];
+        if (j > 0 && public_keys[i] == public_keys[order[j - 1]]) {
+            group[i] = group[order[j - 1]];
+            continue;
+        }
+        const ECPoint& Q = public_keys[i];
+        group[i] = (long)group_key.size();
+        group_key.push_back(i);
+        group_ok.push_back(!Q.is_infinity() && Q.curve() == &curve && Q.is_on_curve());
+    }
+    
+    // Ecuacion del lote: G, una entrada por clave y una por R_i
+    BigInt g_coeff(0);
+    std::vector<BigInt> key_coeff(group_key.size(), BigInt(0));
+    std::vector<BigInt> scalars;
+    std::vector<ECPoint> points;
+    std::vector<size_t> batched, single;
+    
+    for (size_t i = 0; i < count; i++) {
+        const ECDSASignature& sig = signatures[i];
+        if (!group_ok[group[i]] || !sig.is_valid_format(curve.n)) continue;
+        
+        ECPoint R(&curve);
+        if (!recover_r_point(sig, curve, R)) {
+            single.push_back(i);
+            continue;
+        }
+        
+        BigInt z = truncate_hash(hashes[i], curve.n);
+        BigInt w = InvMod(sig.s, curve.n);
+        BigInt a = rng.random_bits(128);
+        if (IsZero(a)) a = 1;
+        
+        g_coeff = (g_coeff + a * ((z * w) % curve.n)) % curve.n;
+        key_coeff[group[i]] = (key_coeff[group[i]] + a * ((sig.r * w) % curve.n)) % curve.n;
+        scalars.push_back(a);                  // a_i * (-R_i): escalar de 128 bits
+        points.push_back(ec_negate(R));
+        batched.push_back(i);
+    }
+    
+    if (!batched.empty()) {
+        scalars.push_back(g_coeff);
+        points.push_back(ECPoint::trusted(curve.Gx, curve.Gy, &curve));
+        for (size_t g = 0; g < group_key.size(); g++) {
+            if (IsZero(key_coeff[g])) continue;
+            scalars.push_back(key_coeff[g]);
+            points.push_back(public_keys[group_key[g]]);
+        }
+        
+        if (ec_multi_scalar_mult(scalars, points).is_infinity()) {
+            for (size_t i : batched) valid[i] = true;
+        } else {
+            single.insert(single.end(), batched.begin(), batched.end());
+        }
+    }
+    
+    // Sin R recuperable, o lote invalido: localizar las firmas malas una a una
+    for (size_t i : single) {
+        valid[i] = ecdsa_verify_hash(hashes[i], signatures[i], public_keys[i], curve, true);
+    }
+    return valid;
+}
+
 bool ecdsa_verify(const std::string& message,
                   const ECDSASignature& signature,
                   const ECPoint& public_key,
@@ -699,6 +1456,64 @@ bool ecdsa_verify(const std::string& message,
     return ecdsa_verify_hash(hash_value, signature, public_key, curve, use_jacobian);
 }
 
+// ============================================================================
+// ECDSA - RECUPERACION DE LA CLAVE PUBLICA
+// ============================================================================
+
+/**
+ * De s*k = z + r*d y R = k*G:
+ *   Q = d*G = r^-1 * (s*R - z*G) = u1*G + u2*R
+ *   u1 = -z * r^-1 mod n,  u2 = s * r^-1 mod n
+ * R sale de (r, recovery_id) con una raiz cuadrada y u1*G + u2*R es la
+ * misma combinacion que la verificacion (tabla de G cacheada, GLV en
+ * secp256k1). En el lote los r^-1 comparten una inversion y los Q otra.
+ */
+std::vector<ECPoint> ecdsa_recover_batch(const std::vector<BigInt>& hashes,
+                                         const std::vector<ECDSASignature>& signatures,
+                                         const CurveParams& curve) {
+    size_t count = hashes.size();
+    if (signatures.size() != count) {
+        throw std::invalid_argument("ECDSA recover: input vectors must have the same size");
+    }
+    check_wnaf_width(curve);
+    const BigInt& n = curve.n;
+    
+    std::vector<size_t> usable;
+    std::vector<BigInt> r_inv;
+    for (size_t i = 0; i < count; i++) {
+        if (!signatures[i].is_valid_format(n)) continue;
+        usable.push_back(i);
+        r_inv.push_back(signatures[i].r);
+    }
+    batch_inv_mod(r_inv, n);
+    
+    return with_native_curve(curve, [&](const auto& E) {
+        using Point = typename std::decay<decltype(E)>::type::Point;
+        std::vector<Point> keys(count, E.infinity());
+        
+        for (size_t j = 0; j < usable.size(); j++) {
+            size_t i = usable[j];
+            const ECDSASignature& sig = signatures[i];
+            
+            BigInt x, y;
+            if (!native_recover_r(E, sig, x, y)) continue;
+            Point R{E.F.from_bigint(x), E.F.from_bigint(y), E.F.one()};
+            
+            BigInt z = truncate_hash(hashes[i], n) % n;
+            BigInt u1 = (n - MulMod(z, r_inv[j], n)) % n;
+            BigInt u2 = MulMod(sig.s, r_inv[j], n);
+            keys[i] = native_generator_mult_add(E, u1, u2, R, curve.wnaf_width);
+        }
+        return native_to_affine_batch(E, std::move(keys));
+    });
+}
+
+ECPoint ecdsa_recover(const BigInt& hash_value,
+                      const ECDSASignature& signature,
+                      const CurveParams& curve) {
+    return ecdsa_recover_batch({hash_value}, {signature}, curve)[0];
+}
+
 // ============================================================================
 // UTILIDADES
 // ============================================================================
@@ -10,6 +10,7 @@
 #include <iomanip>
 #include <stdexcept>
 #include <sstream>
+#include <atomic>
 
 namespace crypto {
 
@@ -77,13 +78,156 @@ GF2X hex_to_gf2x(const std::string& hex_str) {
     return result;
 }
 
+// ============================================================================
+// ARITMETICA EN Z[tau] (CURVAS DE KOBLITZ)
+// ============================================================================
+
+namespace {
+
+/**
+ * Elemento r0 + r1*tau de Z[tau], con tau^2 = mu*tau - 2 (mu = +-1)
+ * 
+ * Norma: N(r0 + r1*tau) = r0^2 + mu*r0*r1 + 2*r1^2
+ * Conjugado: tau' = mu - tau, y tau * tau' = 2
+ */
+struct ZTau {
+    BigInt r0;
+    BigInt r1;
+};
+
+ZTau ztau_mul(const ZTau& a, const ZTau& b, int mu) {
+    // (a0 + a1 t)(b0 + b1 t) = a0 b0 + (a0 b1 + a1 b0) t + a1 b1 (mu t - 2)
+    BigInt a1b1 = a.r1 * b.r1;
+    return ZTau{a.r0 * b.r0 - 2 * a1b1, a.r0 * b.r1 + a.r1 * b.r0 + mu * a1b1};
+}
+
+BigInt ztau_norm(const ZTau& a, int mu) {
+    return a.r0 * a.r0 + mu * a.r0 * a.r1 + 2 * a.r1 * a.r1;
+}
+
+ZTau ztau_tau_power(long e, int mu) {
+    ZTau t{to_ZZ(1), to_ZZ(0)};
+    ZTau tau{to_ZZ(0), to_ZZ(1)};
+    for (long i = 0; i < e; i++) {
+        t = ztau_mul(t, tau, mu);
+    }
+    return t;
+}
+
+/** floor(a / b + 1/2) con b > 0 (la division de ZZ redondea hacia -inf) */
+BigInt round_div(const BigInt& a, const BigInt& b) {
+    return (2 * a + b) / (2 * b);
+}
+
+/**
+ * Redondeo de (l0 + l1*tau) / den al elemento mas cercano de Z[tau]
+ * (Solinas, 2000; Guide to ECC, alg. 3.63), en enteros: e_i = eta_i * den
+ */
+ZTau ztau_round(const BigInt& l0, const BigInt& l1, const BigInt& den, int mu) {
+    BigInt f0 = round_div(l0, den);
+    BigInt f1 = round_div(l1, den);
+    BigInt e0 = l0 - f0 * den;
+    BigInt e1 = l1 - f1 * den;
+    
+    BigInt eta = 2 * e0 + mu * e1;
+    BigInt t3 = e0 - 3 * mu * e1;
+    BigInt t4 = e0 + 4 * mu * e1;
+    long h0 = 0, h1 = 0;
+    
+    if (eta >= den) {
+        if (t3 < -den) h1 = mu; else h0 = 1;
+    } else if (t4 >= 2 * den) {
+        h1 = mu;
+    }
+    if (eta < -den) {
+        if (t3 >= den) h1 = -mu; else h0 = -1;
+    } else if (t4 < -2 * den) {
+        h1 = -mu;
+    }
+    
+    return ZTau{f0 + h0, f1 + h1};
+}
+
+/**
+ * k mod delta en Z[tau] (Guide to ECC, alg. 3.62): q = round(k / delta),
+ * con k / delta = k * conj(delta) / N(delta), y r = k - delta * q.
+ * El resto es congruente con k cualquiera que sea q; el redondeo solo
+ * garantiza que sea corto (N(r) < N(delta)).
+ */
+ZTau ztau_mod(const BigInt& k, const ZTau& delta, const BigInt& norm, int mu) {
+    // conj(d0 + d1 tau) = (d0 + mu d1) - d1 tau
+    ZTau q = ztau_round(k * (delta.r0 + mu * delta.r1), -k * delta.r1, norm, mu);
+    ZTau dq = ztau_mul(delta, q, mu);
+    return ZTau{k - dq.r0, -dq.r1};
+}
+
+} // namespace
+
 // ============================================================================
 // PARAMETROS DE CURVAS BINARIAS ESTANDAR
 // ============================================================================
 
+namespace {
+
+// Campo de GF2E activo en cada hilo: field_id de la cache restaurada por
+// ultima vez (0 = ninguno conocido). Se usa un identificador y no la
+// direccion del contexto porque una cache liberada puede dejar su
+// direccion a la de otra curva.
+thread_local uint64_t active_field_id = 0;
+
+std::atomic<uint64_t> next_field_id{1};
+
+} // namespace
+
 void BinaryCurveParams::init_field() const {
-    // Inicializar GF(2^m) con el polinomio irreducible
-    GF2E::init(reduction_poly);
+    const BinaryCurveCache& c = cache();
+    if (active_field_id != c.field_id) {
+        c.field.restore();
+        active_field_id = c.field_id;
+    }
+}
+
+BinaryCurveCache::BinaryCurveCache(const BinaryCurveParams& curve)
+    : field(curve.reduction_poly), field_id(next_field_id.fetch_add(1)) {
+    // conv<GF2E> reduce modulo el polinomio activo: fijar el de la curva
+    // solo durante la conversion, sin tocar el campo de quien llama
+    GF2EPush push(field);
+    a = curve.hex_to_gf2e(curve.a_hex);
+    b = curve.hex_to_gf2e(curve.b_hex);
+    Gx = curve.hex_to_gf2e(curve.Gx_hex);
+    Gy = curve.hex_to_gf2e(curve.Gy_hex);
+    
+    // Koblitz: E_a con a en {0, 1} y b = 1, mu = (-1)^(1-a). Se exige
+    // ademas N(delta) = n para que reducir modulo delta sea valido en el
+    // subgrupo de G (delta = (tau^m - 1)/(tau - 1), N(tau - 1) = 3 - mu = h)
+    if ((IsZero(a) || IsOne(a)) && IsOne(b) && curve.m > 0) {
+        int mu_ = IsOne(a) ? 1 : -1;
+        ZTau t = ztau_tau_power(curve.m, mu_);
+        t.r0 -= 1;
+        ZTau num = ztau_mul(t, ZTau{to_ZZ(mu_ - 1), to_ZZ(-1)}, mu_);
+        long h = 3 - mu_;
+        if (num.r0 % h == 0 && num.r1 % h == 0) {
+            ZTau delta{num.r0 / h, num.r1 / h};
+            if (ztau_norm(delta, mu_) == curve.n) {
+                koblitz = true;
+                mu = mu_;
+                d0 = delta.r0;
+                d1 = delta.r1;
+            }
+        }
+    }
+}
+
+const BinaryCurveCache& BinaryCurveParams::cache() const {
+    // Publicacion atomica, como CurveParams::cache()
+    std::shared_ptr<const BinaryCurveCache> current = std::atomic_load(&cache_);
+    if (!current) {
+        auto fresh = std::make_shared<const BinaryCurveCache>(*this);
+        if (std::atomic_compare_exchange_strong(&cache_, &current, fresh)) {
+            current = fresh;
+        }
+    }
+    return *current;
 }
 
 GF2E BinaryCurveParams::hex_to_gf2e(const std::string& hex) const {
@@ -96,9 +240,7 @@ bool BinaryCurveParams::validate() const {
     if (deg(reduction_poly) != m) return false;
     
     // Verificar que b != 0 (requerido para curva no singular)
-    init_field();
-    GF2E b = hex_to_gf2e(b_hex);
-    if (IsZero(b)) return false;
+    if (IsZero(cache().b)) return false;
     
     if (n <= 0) return false;
     if (h <= 0) return false;
@@ -343,8 +485,8 @@ bool BinaryECPoint::is_on_curve() const {
     
     curve_->init_field();
     
-    GF2E a = curve_->hex_to_gf2e(curve_->a_hex);
-    GF2E b = curve_->hex_to_gf2e(curve_->b_hex);
+    const GF2E& a = curve_->cache().a;
+    const GF2E& b = curve_->cache().b;
     
     // LHS = y^2 + x*y
     GF2E lhs = sqr(y_) + x_ * y_;
@@ -356,6 +498,40 @@ bool BinaryECPoint::is_on_curve() const {
     return lhs == rhs;
 }
 
+// ============================================================================
+// BinaryLDPoint - IMPLEMENTACION
+// ============================================================================
+
+BinaryLDPoint::BinaryLDPoint(const BinaryCurveParams* curve)
+    : curve_(curve) {
+    if (!curve_) {
+        throw std::invalid_argument("Curve parameters cannot be null");
+    }
+    curve_->init_field();
+    clear(X_);
+    clear(Y_);
+    clear(Z_);
+}
+
+BinaryLDPoint::BinaryLDPoint(const GF2E& X, const GF2E& Y, const GF2E& Z,
+                             const BinaryCurveParams* curve)
+    : X_(X), Y_(Y), Z_(Z), curve_(curve) {
+    if (!curve_) {
+        throw std::invalid_argument("Curve parameters cannot be null");
+    }
+}
+
+void BinaryLDPoint::print() const {
+    if (is_infinity()) {
+        std::cout << "Binary LD Point at infinity (Z = 0)\n";
+    } else {
+        std::cout << "Binary LD Point (X : Y : Z):\n";
+        std::cout << "  X = " << X_ << "\n";
+        std::cout << "  Y = " << Y_ << "\n";
+        std::cout << "  Z = " << Z_ << "\n";
+    }
+}
+
 bool BinaryECPoint::operator==(const BinaryECPoint& other) const {
     if (curve_ != other.curve_) return false;
     if (is_infinity_ && other.is_infinity_) return true;
@@ -416,7 +592,7 @@ BinaryECPoint binary_ec_add(const BinaryECPoint& P, const BinaryECPoint& Q) {
         return BinaryECPoint(curve);
     }
     
-    GF2E a = curve->hex_to_gf2e(curve->a_hex);
+    const GF2E& a = curve->cache().a;
     
     // lambda = (y1 + y2) / (x1 + x2)
     GF2E lambda = (P.y() + Q.y()) / (P.x() + Q.x());
@@ -456,7 +632,7 @@ BinaryECPoint binary_ec_double(const BinaryECPoint& P) {
         return BinaryECPoint(curve);
     }
     
-    GF2E a = curve->hex_to_gf2e(curve->a_hex);
+    const GF2E& a = curve->cache().a;
     
     // lambda = x1 + y1/x1
     GF2E lambda = P.x() + P.y() / P.x();
@@ -521,11 +697,522 @@ BinaryECPoint binary_ec_scalar_mult(const BigInt& k, const BinaryECPoint& P,
     return result;
 }
 
+// ============================================================================
+// OPERACIONES EN COORDENADAS LOPEZ-DAHAB
+// ============================================================================
+
+namespace {
+
+/**
+ * c * x para un coeficiente de la curva: en las curvas SEC 2 a y b suelen
+ * ser 0 o 1, y entonces el producto no cuesta nada
+ */
+GF2E mul_coeff(const GF2E& c, const GF2E& x) {
+    if (IsZero(c)) return GF2E();
+    if (IsOne(c)) return x;
+    return c * x;
+}
+
+/**
+ * Pertenencia al subgrupo de orden n en una curva de Koblitz, sin
+ * multiplicar por n (el tauNAF solo es correcto ahi: reduce k modulo
+ * delta, que anula ese subgrupo pero no la parte de cofactor).
+ * 
+ * Se usa que P esta en 2E si y solo si Tr(x) = Tr(a) (Seroussi). Como
+ * E = Z/h x Z/n con h = 2 o 4 (una sola parte 2 ciclica):
+ *   h = 2: subgrupo = 2E, basta la traza
+ *   h = 4: subgrupo = 4E; si P = 2Q, Q sale de lambda^2 + lambda = x + a
+ *          (semitraza, m impar) y x(Q)^2 = x*(lambda + 1) + y, y se
+ *          repite la prueba con x(Q). Las dos mitades Q y Q + (0, sqrt(b))
+ *          dan la misma respuesta, asi que sirve cualquier raiz lambda.
+ * Coste ~2m cuadrados, frente a una multiplicacion escalar para n*P = O.
+ */
+bool koblitz_in_subgroup(const BinaryECPoint& P) {
+    const BinaryCurveParams* curve = P.curve();
+    const BinaryCurveCache& c = curve->cache();
+    if (P.is_infinity()) return true;
+    if (IsZero(P.x())) return false;     // (0, sqrt(b)) es de orden 2
+    
+    GF2 tr_a = trace(c.a);
+    if (trace(P.x()) != tr_a) return false;
+    if (curve->h == 2) return true;
+    if (curve->h != 4 || curve->m % 2 == 0) return false;
+    
+    // Semitraza: H(z) = sum_{i=0}^{(m-1)/2} z^(2^(2i)) resuelve l^2 + l = z
+    GF2E z = P.x() + c.a;
+    GF2E lambda = z;
+    for (int i = 1; i <= (curve->m - 1) / 2; i++) {
+        z = sqr(sqr(z));
+        lambda += z;
+    }
+    
+    // Raiz cuadrada: w^(2^(m-1))
+    GF2E u = P.x() * (lambda + 1) + P.y();
+    for (int i = 1; i < curve->m; i++) {
+        u = sqr(u);
+    }
+    return trace(u) == tr_a;
+}
+
+} // namespace
+
+BinaryLDPoint binary_to_ld(const BinaryECPoint& P) {
+    if (P.is_infinity()) return BinaryLDPoint(P.curve());
+    
+    P.curve()->init_field();
+    GF2E one;
+    set(one);
+    return BinaryLDPoint(P.x(), P.y(), one, P.curve());
+}
+
+/**
+ * Una sola inversion: Z^-1, y de ahi x = X * Z^-1, y = Y * (Z^-1)^2
+ */
+BinaryECPoint binary_to_affine(const BinaryLDPoint& P) {
+    if (P.is_infinity()) return BinaryECPoint(P.curve());
+    
+    P.curve()->init_field();
+    GF2E z_inv = inv(P.Z());
+    return BinaryECPoint(P.X() * z_inv, P.Y() * sqr(z_inv), P.curve());
+}
+
+/**
+ * Doblado en Lopez-Dahab (Lopez y Dahab, 1998; Hankerson et al., Guide
+ * to ECC, alg. 3.24):
+ *   Z3 = X1^2 * Z1^2
+ *   X3 = X1^4 + b*Z1^4
+ *   Y3 = b*Z1^4 * Z3 + X3 * (a*Z3 + Y1^2 + b*Z1^4)
+ * 
+ * Como en afines, si x = X1/Z1 = 0 el punto es de orden 2 y 2P = O (la
+ * formula lo da sola: Z3 = 0).
+ */
+BinaryLDPoint binary_ld_double(const BinaryLDPoint& P) {
+    if (P.is_infinity()) return P;
+    
+    const BinaryCurveParams* curve = P.curve();
+    curve->init_field();
+    const BinaryCurveCache& c = curve->cache();
+    
+    if (IsZero(P.X())) {
+        return BinaryLDPoint(curve);
+    }
+    
+    GF2E X1_sq = sqr(P.X());
+    GF2E Z1_sq = sqr(P.Z());
+    GF2E bZ1_4 = mul_coeff(c.b, sqr(Z1_sq));
+    
+    GF2E Z3 = X1_sq * Z1_sq;
+    GF2E X3 = sqr(X1_sq) + bZ1_4;
+    GF2E Y3 = bZ1_4 * Z3 + X3 * (mul_coeff(c.a, Z3) + sqr(P.Y()) + bZ1_4);
+    
+    return BinaryLDPoint(X3, Y3, Z3, curve);
+}
+
+/**
+ * Suma mixta Lopez-Dahab + afin (Al-Daoud et al., 2002; Guide to ECC,
+ * alg. 3.25), con P = (X1 : Y1 : Z1) y Q = (x2, y2):
+ *   A = y2*Z1^2 + Y1        B = x2*Z1 + X1
+ *   C = Z1*B                D = B^2 * (C + a*Z1^2)
+ *   Z3 = C^2                E = A*C
+ *   X3 = A^2 + D + E
+ *   Y3 = (E + Z3) * (X3 + x2*Z3) + (x2 + y2) * Z3^2
+ * 
+ * B = 0 significa misma x: si ademas A = 0 es P = Q (doblar); si no,
+ * P = -Q y la suma es O.
+ */
+BinaryLDPoint binary_ld_add_mixed(const BinaryLDPoint& P, const BinaryECPoint& Q) {
+    if (P.curve() != Q.curve()) {
+        throw std::invalid_argument("Points must be on the same curve");
+    }
+    
+    const BinaryCurveParams* curve = P.curve();
+    curve->init_field();
+    
+    if (Q.is_infinity()) return P;
+    if (P.is_infinity()) return binary_to_ld(Q);
+    
+    const BinaryCurveCache& c = curve->cache();
+    
+    GF2E Z1_sq = sqr(P.Z());
+    GF2E A = Q.y() * Z1_sq + P.Y();
+    GF2E B = Q.x() * P.Z() + P.X();
+    
+    if (IsZero(B)) {
+        if (IsZero(A)) {
+            return binary_ld_double(binary_to_ld(Q));
+        }
+        return BinaryLDPoint(curve);
+    }
+    
+    GF2E C = P.Z() * B;
+    GF2E D = sqr(B) * (C + mul_coeff(c.a, Z1_sq));
+    GF2E Z3 = sqr(C);
+    GF2E E = A * C;
+    GF2E X3 = sqr(A) + D + E;
+    GF2E Y3 = (E + Z3) * (X3 + Q.x() * Z3) + (Q.x() + Q.y()) * sqr(Z3);
+    
+    return BinaryLDPoint(X3, Y3, Z3, curve);
+}
+
+/**
+ * Multiplicacion escalar en Lopez-Dahab: k * P
+ * 
+ * Mismo double-and-add que binary_ec_scalar_mult, pero de izquierda a
+ * derecha: asi el sumando es siempre P (afin) y basta la suma mixta.
+ * Para k de m bits: m doblados LD + ~m/2 sumas mixtas + 1 inversion.
+ */
+BinaryECPoint binary_ec_scalar_mult_ld(const BigInt& k, const BinaryECPoint& P,
+                                       const BigInt& order) {
+    if (k == 0 || P.is_infinity()) {
+        return BinaryECPoint(P.curve());
+    }
+    
+    // tauNAF solo en el subgrupo de orden n: una clave externa con
+    // componente de cofactor va por double-and-add, como los demas metodos
+    const BinaryCurveParams* curve = P.curve();
+    curve->init_field();
+    if (curve->use_frobenius && order == curve->n && curve->cache().koblitz
+        && koblitz_in_subgroup(P)) {
+        return binary_ec_scalar_mult_tnaf(k, P, order);
+    }
+    
+    BigInt k_red = k % order;
+    
+    BinaryLDPoint result(P.curve());  // Infinito
+    for (long i = NumBits(k_red) - 1; i >= 0; i--) {
+        result = binary_ld_double(result);
+        if (bit(k_red, i)) {
+            result = binary_ld_add_mixed(result, P);
+        }
+    }
+    
+    return binary_to_affine(result);
+}
+
+// ============================================================================
+// tauNAF EN CURVAS DE KOBLITZ
+// ============================================================================
+
+namespace {
+
+/**
+ * Constantes de la ventana w: t_w (imagen de tau en Z/2^w) y los
+ * representantes alpha_u = u mod tau^w de los digitos u = 1, 3, ...
+ */
+struct TnafWindow {
+    long t_w;
+    std::vector<ZTau> alpha;    // alpha[i] para u = 2i + 1
+};
+
+/**
+ * Z[tau] -> Z/2^w con tau -> t_w tiene nucleo tau^w * Z[tau], asi que
+ * r0 + r1*t_w mod 2^w identifica r mod tau^w (Guide to ECC, sec. 3.4).
+ * Con la sucesion de Lucas U_0 = 0, U_1 = 1, U_{k+1} = mu*U_k - 2*U_{k-1}
+ * (tau^k = U_k*tau - 2*U_{k-1}): t_w = 2 * U_{w-1} * U_w^-1 mod 2^w.
+ */
+TnafWindow tnaf_window(int w, int mu) {
+    long mod = 1L << w;
+    long u_prev = 0, u = 1;
+    for (int i = 1; i < w; i++) {
+        long next = mu * u - 2 * u_prev;
+        u_prev = u;
+        u = next;
+    }
+    
+    // U_w es impar: inverso modulo 2^w por busqueda (2^w <= 128)
+    long u_w = ((u % mod) + mod) % mod;
+    long u_inv = 1;
+    while ((u_w * u_inv) % mod != 1) u_inv += 2;
+    
+    TnafWindow win;
+    win.t_w = (((2 * u_prev * u_inv) % mod) + mod) % mod;
+    
+    ZTau tau_w = ztau_tau_power(w, mu);
+    BigInt norm = power2_ZZ(w);
+    for (long d = 1; d < mod / 2; d += 2) {
+        win.alpha.push_back(ztau_mod(to_ZZ(d), tau_w, norm, mu));
+    }
+    return win;
+}
+
+/**
+ * Recodificacion tauNAF de ventana w de r (Guide to ECC, alg. 3.69):
+ * mientras r != 0, si r0 es impar el digito es u = r0 + r1*t_w mods 2^w
+ * y r -= alpha_u (r queda divisible por tau^w: los w-1 digitos
+ * siguientes son 0); despues r = r / tau. Digitos de menor a mayor peso.
+ */
+std::vector<int> tnaf_recode(ZTau r, int w, int mu, const TnafWindow& win) {
+    std::vector<int> digits;
+    long mod = 1L << w;
+    
+    while (!IsZero(r.r0) || !IsZero(r.r1)) {
+        int d = 0;
+        if (IsOdd(r.r0)) {
+            long u = (r.r0 + r.r1 * win.t_w) % mod;
+            if (u >= mod / 2) u -= mod;
+            d = (int)u;
+            const ZTau& a = win.alpha[(d > 0 ? d : -d) / 2];
+            if (d > 0) {
+                r.r0 -= a.r0;
+                r.r1 -= a.r1;
+            } else {
+                r.r0 += a.r0;
+                r.r1 += a.r1;
+            }
+        }
+        digits.push_back(d);
+        
+        // (r0 + r1 tau) / tau = (r1 + mu r0/2) - (r0/2) tau
+        BigInt half = r.r0 / 2;
+        r.r0 = r.r1 + mu * half;
+        r.r1 = -half;
+    }
+    return digits;
+}
+
+/** tau(P) = (X^2 : Y^2 : Z^2): la curva tiene coeficientes en GF(2) */
+BinaryLDPoint ld_frobenius(const BinaryLDPoint& P) {
+    return BinaryLDPoint(sqr(P.X()), sqr(P.Y()), sqr(P.Z()), P.curve());
+}
+
+/**
+ * Horner en tau: Q = sum d_i tau^i (P), con pos[i] = alpha_{2i+1} P y
+ * neg[i] = -pos[i] en afines
+ */
+BinaryLDPoint tnaf_eval(const std::vector<int>& digits,
+                        const std::vector<BinaryECPoint>& pos,
+                        const std::vector<BinaryECPoint>& neg,
+                        const BinaryCurveParams* curve) {
+    BinaryLDPoint Q(curve);
+    for (size_t i = digits.size(); i-- > 0; ) {
+        Q = ld_frobenius(Q);
+        int d = digits[i];
+        if (d > 0) {
+            Q = binary_ld_add_mixed(Q, pos[d / 2]);
+        } else if (d < 0) {
+            Q = binary_ld_add_mixed(Q, neg[-d / 2]);
+        }
+    }
+    return Q;
+}
+
+/**
+ * binary_to_affine de varios puntos con una sola inversion (truco de
+ * Montgomery sobre los Z); los infinitos se conservan
+ */
+std::vector<BinaryECPoint> ld_to_affine_batch(const std::vector<BinaryLDPoint>& points,
+                                              const BinaryCurveParams* curve) {
+    size_t n = points.size();
+    std::vector<GF2E> prefix(n);
+    GF2E acc;
+    set(acc);
+    for (size_t i = 0; i < n; i++) {
+        if (!points[i].is_infinity()) acc *= points[i].Z();
+        prefix[i] = acc;
+    }
+    
+    std::vector<BinaryECPoint> out(n, BinaryECPoint(curve));
+    GF2E acc_inv = inv(acc);
+    for (size_t i = n; i-- > 0; ) {
+        if (points[i].is_infinity()) continue;
+        // 1/Z_i = (Z_0 ... Z_{i-1}) / (Z_0 ... Z_i)
+        GF2E z_inv = (i > 0) ? acc_inv * prefix[i - 1] : acc_inv;
+        acc_inv *= points[i].Z();
+        out[i] = BinaryECPoint(points[i].X() * z_inv, points[i].Y() * sqr(z_inv), curve);
+    }
+    return out;
+}
+
+} // namespace
+
+/**
+ * La tabla alpha_u * P se construye con tauNAF de ventana 2 de cada
+ * alpha_u (normas < 2^w: unos pocos Frobenius y sumas con +-P) y se pasa
+ * a afines con una sola inversion para poder usar la suma mixta.
+ */
+BinaryECPoint binary_ec_scalar_mult_tnaf(const BigInt& k, const BinaryECPoint& P,
+                                         const BigInt& order, int w) {
+    if (w < 2 || w > 7) {
+        throw std::invalid_argument("tauNAF width must be between 2 and 7");
+    }
+    
+    const BinaryCurveParams* curve = P.curve();
+    curve->init_field();
+    const BinaryCurveCache& c = curve->cache();
+    if (!c.koblitz) {
+        throw std::invalid_argument("tauNAF requires a Koblitz curve");
+    }
+    
+    BigInt k_red = k % order;
+    if (IsZero(k_red) || P.is_infinity()) {
+        return BinaryECPoint(curve);
+    }
+    
+    // 1. rho = k mod delta
+    ZTau rho = ztau_mod(k_red, ZTau{c.d0, c.d1}, curve->n, c.mu);
+    
+    // 2. Digitos de rho y de cada alpha_u (estos en ventana 2, digitos +-1)
+    TnafWindow win = tnaf_window(w, c.mu);
+    std::vector<int> digits = tnaf_recode(rho, w, c.mu, win);
+    
+    TnafWindow win2 = tnaf_window(2, c.mu);
+    std::vector<BinaryECPoint> base_pos{P};
+    std::vector<BinaryECPoint> base_neg{binary_ec_negate(P)};
+    std::vector<BinaryLDPoint> table_ld;
+    for (const ZTau& a : win.alpha) {
+        table_ld.push_back(tnaf_eval(tnaf_recode(a, 2, c.mu, win2),
+                                     base_pos, base_neg, curve));
+    }
+    std::vector<BinaryECPoint> pos = ld_to_affine_batch(table_ld, curve);
+    std::vector<BinaryECPoint> neg;
+    for (const BinaryECPoint& T : pos) {
+        neg.push_back(binary_ec_negate(T));
+    }
+    
+    // 3. Horner en tau con sumas mixtas
+    return binary_to_affine(tnaf_eval(digits, pos, neg, curve));
+}
+
+// ============================================================================
+// ESCALERA DE MONTGOMERY x-ONLY (LOPEZ-DAHAB)
+// ============================================================================
+
+namespace {
+
+/**
+ * Intercambia a y b si bit = 1, sin saltos (como FpField::cswap): ambos se
+ * extienden a GF2E::WordLength() palabras y se mezclan con una mascara
+ */
+void gf2e_cswap(GF2E& a, GF2E& b, long bit) {
+    GF2X& ra = a.LoopHole();
+    GF2X& rb = b.LoopHole();
+    long words = GF2E::WordLength();
+    for (GF2X* r : {&ra, &rb}) {
+        long len = r->xrep.length();
+        r->xrep.SetLength(words);
+        for (long i = len; i < words; i++) r->xrep[i] = 0;
+    }
+    
+    _ntl_ulong mask = 0 - (_ntl_ulong)(bit & 1);
+    for (long i = 0; i < words; i++) {
+        _ntl_ulong t = (ra.xrep[i] ^ rb.xrep[i]) & mask;
+        ra.xrep[i] ^= t;
+        rb.xrep[i] ^= t;
+    }
+    ra.normalize();
+    rb.normalize();
+}
+
+/**
+ * Escalera de Lopez-Dahab (Lopez y Dahab, CHES 1999; Guide to ECC,
+ * alg. 3.40) para P = (x, y) con x != 0: deja (X1 : Z1) = k*P y
+ * (X2 : Z2) = (k+1)*P. pad debe anular P: se usa order*h, que con
+ * order = n es el numero de puntos de la curva, asi que k' = k + pad da
+ * k*P tambien para puntos con componente de cofactor (con k + n no).
+ * 
+ * Las formulas de x-only no fallan con el infinito (Z = 0) en medio: la
+ * diferencia R2 - R1 = P fija el resultado de la suma.
+ */
+void ld_ladder(const BigInt& k_red, const BigInt& pad, const GF2E& x,
+               const GF2E& b, GF2E& X1, GF2E& Z1, GF2E& X2, GF2E& Z2) {
+    // k' = k + pad o k + 2*pad tiene siempre bits(pad) + 1 bits; se elige
+    // con aritmetica (c = bit alto de k + pad), sin saltar segun k
+    long nbits = NumBits(pad);
+    BigInt kk = k_red + pad;
+    kk += (1 - bit(kk, nbits)) * pad;
+    
+    // El bit de arriba de k' (siempre 1) ya esta en R1 = P, R2 = 2P
+    X1 = x;
+    set(Z1);
+    Z2 = sqr(x);
+    X2 = sqr(Z2) + b;
+    
+    // Los bits de k' solo mueven mascaras: intercambio condicional sin
+    // saltos, como en la escalera de campos primos
+    long swapped = 0;
+    for (long i = nbits - 1; i >= 0; i--) {
+        long bi = bit(kk, i);
+        gf2e_cswap(X1, X2, bi ^ swapped);
+        gf2e_cswap(Z1, Z2, bi ^ swapped);
+        swapped = bi;
+        
+        // R2 = R1 + R2
+        GF2E T1 = X1 * Z2;
+        GF2E T2 = X2 * Z1;
+        Z2 = sqr(T1 + T2);
+        X2 = x * Z2 + T1 * T2;
+        
+        // R1 = 2*R1
+        GF2E X1_sq = sqr(X1);
+        GF2E Z1_sq = sqr(Z1);
+        Z1 = X1_sq * Z1_sq;
+        X1 = sqr(X1_sq) + mul_coeff(b, sqr(Z1_sq));
+    }
+    gf2e_cswap(X1, X2, swapped);
+    gf2e_cswap(Z1, Z2, swapped);
+}
+
+} // namespace
+
+bool binary_ec_ladder_x(const BigInt& k, const BinaryECPoint& P,
+                        const BigInt& order, GF2E& x) {
+    BigInt k_red = k % order;
+    if (IsZero(k_red) || P.is_infinity()) return false;
+    
+    const BinaryCurveParams* curve = P.curve();
+    curve->init_field();
+    
+    // x = 0: P es de orden 2
+    if (IsZero(P.x())) {
+        if (!IsOdd(k_red)) return false;
+        x = P.x();
+        return true;
+    }
+    
+    GF2E X1, Z1, X2, Z2;
+    ld_ladder(k_red, order * curve->h, P.x(), curve->cache().b, X1, Z1, X2, Z2);
+    if (IsZero(Z1)) return false;
+    
+    x = X1 / Z1;
+    return true;
+}
+
+BinaryECPoint binary_ec_scalar_mult_ladder(const BigInt& k, const BinaryECPoint& P,
+                                           const BigInt& order) {
+    const BinaryCurveParams* curve = P.curve();
+    BigInt k_red = k % order;
+    if (IsZero(k_red) || P.is_infinity()) return BinaryECPoint(curve);
+    
+    curve->init_field();
+    
+    if (IsZero(P.x())) {
+        return IsOdd(k_red) ? P : BinaryECPoint(curve);
+    }
+    
+    const GF2E& x = P.x();
+    const GF2E& y = P.y();
+    GF2E X1, Z1, X2, Z2;
+    ld_ladder(k_red, order * curve->h, x, curve->cache().b, X1, Z1, X2, Z2);
+    
+    // k*P = O, o (k+1)*P = O y entonces k*P = -P
+    if (IsZero(Z1)) return BinaryECPoint(curve);
+    if (IsZero(Z2)) return binary_ec_negate(P);
+    
+    // t = 1 / (x*Z1*Z2); 1/Z1 = x*Z2*t
+    GF2E xZ2 = x * Z2;
+    GF2E t = inv(xZ2 * Z1);
+    GF2E x3 = X1 * xZ2 * t;
+    GF2E y3 = (x + x3) * ((X1 + x * Z1) * (X2 + xZ2) + (sqr(x) + y) * (Z1 * Z2)) * t + y;
+    
+    return BinaryECPoint(x3, y3, curve);
+}
+
 // ============================================================================
 // CLAVES Y OPERACIONES CRIPTOGRAFICAS
 // ============================================================================
 
-BinaryECKeyPair binary_generate_keypair(const BinaryCurveParams& curve, RNG& rng) {
+BinaryECKeyPair binary_generate_keypair(const BinaryCurveParams& curve, RNG& rng,
+                                        bool use_ld) {
     // Inicializar campo
     curve.init_field();
     
@@ -533,11 +1220,11 @@ BinaryECKeyPair binary_generate_keypair(const BinaryCurveParams& curve, RNG& rng
     BigInt private_key = rng.random_range(to_ZZ(1), curve.n - 1);
     
     // 2. Calcular clave publica: Q = d * G
-    GF2E Gx = curve.hex_to_gf2e(curve.Gx_hex);
-    GF2E Gy = curve.hex_to_gf2e(curve.Gy_hex);
-    BinaryECPoint G(Gx, Gy, &curve);
+    BinaryECPoint G(curve.cache().Gx, curve.cache().Gy, &curve);
     
-    BinaryECPoint public_key = binary_ec_scalar_mult(private_key, G, curve.n);
+    BinaryECPoint public_key = use_ld
+        ? binary_ec_scalar_mult_ld(private_key, G, curve.n)
+        : binary_ec_scalar_mult(private_key, G, curve.n);
     
     return BinaryECKeyPair{private_key, public_key, &curve};
 }
@@ -562,10 +1249,24 @@ void BinaryECKeyPair::print(bool show_private) const {
 
 BinaryECPoint binary_ecdh_shared_secret(const BigInt& private_key,
                                         const BinaryECPoint& public_key,
-                                        const BigInt& order) {
+                                        const BigInt& order,
+                                        bool use_ld) {
+    if (use_ld) {
+        return binary_ec_scalar_mult_ld(private_key, public_key, order);
+    }
     return binary_ec_scalar_mult(private_key, public_key, order);
 }
 
+GF2E binary_ecdh_shared_x(const BigInt& private_key,
+                          const BinaryECPoint& public_key,
+                          const BigInt& order) {
+    GF2E x;
+    if (!binary_ec_ladder_x(private_key, public_key, order, x)) {
+        throw std::runtime_error("ECDH shared secret is the point at infinity");
+    }
+    return x;
+}
+
 // ============================================================================
 // UTILIDADES
 // ============================================================================
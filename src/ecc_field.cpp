@@ -0,0 +1,212 @@
+// ecc_field.cpp
+// Campo primo Fp de tamano fijo: constantes de Montgomery, deteccion de
+// primos de Solinas, inversion y conversion con BigInt (la aritmetica
+// caliente esta inline en la cabecera)
+//
+// Autor: Leon Elliott Fuller
+// Fecha: 2026-10-16
+
+#include "ecc_field.hpp"
+#include <stdexcept>
+
+namespace crypto {
+
+// ============================================================================
+// CONVERSION LIMBS <-> BigInt
+// ============================================================================
+
+namespace {
+
+// x debe estar en [0, 2^(64N)); BytesFromZZ produce little-endian
+template<size_t N>
+FpElem<N> limbs_from_bigint(const BigInt& x) {
+    unsigned char buf[8 * N];
+    BytesFromZZ(buf, x, 8 * N);
+
+    FpElem<N> r;
+    for (size_t i = 0; i < N; i++) {
+        uint64_t w = 0;
+        for (size_t b = 0; b < 8; b++) {
+            w |= (uint64_t)buf[8 * i + b] << (8 * b);
+        }
+        r.v[i] = w;
+    }
+    return r;
+}
+
+template<size_t N>
+BigInt bigint_from_limbs(const FpElem<N>& a) {
+    unsigned char buf[8 * N];
+    for (size_t i = 0; i < N; i++) {
+        for (size_t b = 0; b < 8; b++) {
+            buf[8 * i + b] = (unsigned char)(a.v[i] >> (8 * b));
+        }
+    }
+    return ZZFromBytes(buf, 8 * N);
+}
+
+/**
+ * Identifica los primos con kernel de reduccion dedicado
+ */
+FpReduction detect_reduction(const BigInt& p) {
+    if (p == power2_ZZ(256) - power2_ZZ(224) + power2_ZZ(192) + power2_ZZ(96) - 1) {
+        return FpReduction::NIST_P256;
+    }
+    if (p == power2_ZZ(384) - power2_ZZ(128) - power2_ZZ(96) + power2_ZZ(32) - 1) {
+        return FpReduction::NIST_P384;
+    }
+    if (p == power2_ZZ(256) - power2_ZZ(32) - 977) {
+        return FpReduction::SECP256K1;
+    }
+    return FpReduction::MONTGOMERY;
+}
+
+} // namespace
+
+// ============================================================================
+// FpField - CONSTRUCCION
+// ============================================================================
+
+template<size_t N>
+FpField<N>::FpField(const BigInt& p, bool allow_special)
+    : reduction_(FpReduction::MONTGOMERY), p_big_(p) {
+    if (p <= 3 || !IsOdd(p)) {
+        throw std::invalid_argument("FpField: modulus must be an odd prime > 3");
+    }
+    if (NumBits(p) > (long)(64 * N)) {
+        throw std::invalid_argument("FpField: modulus does not fit in the limb count");
+    }
+
+    p_ = limbs_from_bigint<N>(p);
+    zero_ = limbs_from_bigint<N>(BigInt(0));
+    inv_exp_ = p - 2;
+    sqrt_fast_ = (p % 4 == 3);
+    if (sqrt_fast_) sqrt_exp_ = (p + 1) / 4;
+
+    // El kernel debe corresponder al tamano de limb (P-384 solo en N = 6)
+    FpReduction special = allow_special ? detect_reduction(p) : FpReduction::MONTGOMERY;
+    bool fits = (special == FpReduction::NIST_P384) ? (N == 6) : (N == 4);
+    if (special != FpReduction::MONTGOMERY && fits) {
+        // Forma normal: 1 = 1, sin constantes de Montgomery
+        reduction_ = special;
+        n0_ = 0;
+        r2_ = zero_;
+        one_ = zero_;
+        one_.v[0] = 1;
+        return;
+    }
+
+    // n0 = -p^(-1) mod 2^64 por Newton-Hensel: cada iteracion duplica
+    // los bits correctos (1 -> 2 -> 4 -> ... -> 64)
+    uint64_t inv = 1;
+    for (int i = 0; i < 6; i++) {
+        inv *= 2 - p_.v[0] * inv;
+    }
+    n0_ = 0 - inv;
+
+    BigInt R = power2_ZZ(64 * N);
+    r2_ = limbs_from_bigint<N>((R * R) % p);
+    one_ = limbs_from_bigint<N>(R % p);
+}
+
+// ============================================================================
+// FpField - INVERSION Y CONVERSIONES
+// ============================================================================
+
+/**
+ * Exponenciacion con ventana fija de 4 bits:
+ *   14 multiplicaciones de precalculo + ~bits(e) cuadrados + una mul por
+ *   ventana no nula (los exponentes de P-256, p-2 y (p+1)/4, son casi
+ *   todo ceros fuera de unos pocos bloques)
+ * No reserva memoria y la secuencia de operaciones depende solo de e
+ * (publico: p-2 o (p+1)/4), no del valor de a.
+ */
+template<size_t N>
+FpElem<N> FpField<N>::pow(const Elem& a, const BigInt& e) const {
+    Elem table[16];
+    table[0] = one_;
+    table[1] = a;
+    for (int i = 2; i < 16; i++) {
+        table[i] = mul(table[i - 1], a);
+    }
+
+    long nbits = NumBits(e);
+    long top = ((nbits + 3) / 4) * 4;
+
+    Elem r = one_;
+    for (long i = top - 4; i >= 0; i -= 4) {
+        r = sqr(sqr(sqr(sqr(r))));
+        int w = (int)((bit(e, i + 3) << 3) | (bit(e, i + 2) << 2) |
+                      (bit(e, i + 1) << 1) | bit(e, i));
+        if (w != 0) r = mul(r, table[w]);   // e es publico: saltar 0 no filtra a
+    }
+    return r;
+}
+
+/**
+ * Inversion por el pequeno teorema de Fermat: a^(-1) = a^(p-2) mod p
+ *
+ * Es mas lenta que Euclides extendido, pero no reserva memoria y su
+ * secuencia de operaciones no depende del valor de a.
+ */
+template<size_t N>
+FpElem<N> FpField<N>::inv(const Elem& a) const {
+    return pow(a, inv_exp_);
+}
+
+/**
+ * Con p = 3 (mod 4), si a es un cuadrado, a^((p+1)/4) es una raiz:
+ *   (a^((p+1)/4))^2 = a^((p+1)/2) = a * a^((p-1)/2) = a  (Euler)
+ * Si a no es un cuadrado el cuadrado sale -a, de ahi la comprobacion.
+ */
+template<size_t N>
+bool FpField<N>::sqrt(const Elem& a, Elem& root) const {
+    if (sqrt_fast_) {
+        root = pow(a, sqrt_exp_);
+        return equal(sqr(root), a);
+    }
+
+    BigInt x = to_bigint(a);
+    if (Jacobi(x, p_big_) < 0) return false;
+    BigInt r;
+    SqrRootMod(r, x, p_big_);
+    root = from_bigint(r);
+    return true;
+}
+
+template<size_t N>
+FpElem<N> FpField<N>::from_bigint(const BigInt& x) const {
+    // x mod p (NTL devuelve un resto no negativo) y luego x * R^2 * R^(-1)
+    Elem raw = limbs_from_bigint<N>(x % p_big_);
+    if (reduction_ != FpReduction::MONTGOMERY) return raw;
+    return mul(raw, r2_);
+}
+
+template<size_t N>
+BigInt FpField<N>::to_bigint(const Elem& a) const {
+    // Salir de forma de Montgomery: a~ * 1 * R^(-1) = a
+    if (reduction_ != FpReduction::MONTGOMERY) return bigint_from_limbs<N>(a);
+    Elem unit = zero_;
+    unit.v[0] = 1;
+    return bigint_from_limbs<N>(mul(a, unit));
+}
+
+template class FpField<4>;
+template class FpField<6>;
+
+// ============================================================================
+// FpContext
+// ============================================================================
+
+FpContext::FpContext(const BigInt& p) {
+    if (p <= 3 || !IsOdd(p)) return;
+
+    long nbits = NumBits(p);
+    if (nbits <= 256) {
+        f4.reset(new FpField<4>(p));
+    } else if (nbits <= 384) {
+        f6.reset(new FpField<6>(p));
+    }
+}
+
+} // namespace crypto
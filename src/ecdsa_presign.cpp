@@ -0,0 +1,230 @@
+// ecdsa_presign.cpp
+// Firma ECDSA offline/online con reserva de nonces precalculados
+//
+// Autor: Leon Elliott Fuller
+// Fecha: 2026-10-16
+
+#include "ecdsa_presign.hpp"
+#include "ecc_native.hpp"
+#include "sha256.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>
+
+namespace crypto {
+
+// ============================================================================
+// CONSTRUCCION Y PARADA
+// ============================================================================
+
+ECDSAPresigner::ECDSAPresigner(const CurveParams& curve, std::unique_ptr<RNG> rng,
+                               size_t capacity, bool background)
+    : curve_(curve), rng_(std::move(rng)), capacity_(capacity) {
+    if (!rng_) {
+        throw std::invalid_argument("Presigner: RNG cannot be null");
+    }
+    if (capacity_ == 0) {
+        throw std::invalid_argument("Presigner: capacity must be positive");
+    }
+    stats_.capacity = capacity_;
+    pool_.reserve(capacity_);
+
+    if (background) {
+        BigInt seed = rng_->random_bits(256);
+        thread_ = std::thread(&ECDSAPresigner::worker, this, seed);
+    }
+}
+
+ECDSAPresigner::~ECDSAPresigner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+// ============================================================================
+// FASE OFFLINE
+// ============================================================================
+
+/**
+ * Lote de tripletas:
+ * - R_i = k_i*G con la tabla de base fija (o el metodo regular de la
+ *   curva) y normalizacion conjunta (una inversion de campo)
+ * - k_i^-1 con el truco de Montgomery modulo n: productos prefijo, una
+ *   sola InvMod y vuelta atras (3 mul por elemento)
+ * Los k con r = 0 se descartan (probabilidad ~1/n).
+ */
+std::vector<ECDSAPresigner::Presig> ECDSAPresigner::produce(RNG& rng, size_t count) {
+    const BigInt& n = curve_.n;
+
+    std::vector<BigInt> ks;
+    ks.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ks.push_back(rng.random_range(to_ZZ(1), n - 1));
+    }
+
+    std::vector<ECPoint> points = with_native_curve(curve_, [&](const auto& E) {
+        using Point = typename std::decay<decltype(E)>::type::Point;
+        std::vector<Point> kG;
+        kG.reserve(count);
+        for (const auto& k : ks) {
+            kG.push_back(native_generator_mult_method(E, k));
+        }
+        return native_to_affine_batch(E, std::move(kG));
+    });
+
+    std::vector<BigInt> prefix(count);
+    BigInt acc(1);
+    for (size_t i = 0; i < count; i++) {
+        prefix[i] = acc;
+        acc = MulMod(acc, ks[i], n);
+    }
+    BigInt inv = InvMod(acc, n);
+
+    std::vector<Presig> out(count);
+    for (size_t i = count; i-- > 0;) {
+        out[i].k_inv = MulMod(inv, prefix[i], n);
+        inv = MulMod(inv, ks[i], n);
+        out[i].r = points[i].x() % n;
+        out[i].recovery_id = (IsOdd(points[i].y()) ? 1 : 0) | (points[i].x() >= n ? 2 : 0);
+    }
+
+    out.erase(std::remove_if(out.begin(), out.end(),
+                             [](const Presig& t) { return IsZero(t.r); }),
+              out.end());
+    return out;
+}
+
+void ECDSAPresigner::push(std::vector<Presig>&& batch, uint64_t elapsed_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t room = capacity_ - std::min(capacity_, pool_.size());
+    size_t take = std::min(room, batch.size());
+    for (size_t i = 0; i < take; i++) {
+        pool_.push_back(std::move(batch[i]));
+    }
+    stats_.produced += take;
+    refill_us_ += elapsed_us;
+}
+
+void ECDSAPresigner::refill() {
+    for (;;) {
+        size_t want;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pool_.size() >= capacity_) return;
+            want = std::min(REFILL_BATCH, capacity_ - pool_.size());
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Presig> batch;
+        {
+            std::lock_guard<std::mutex> lock(rng_mutex_);
+            batch = produce(*rng_, want);
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        push(std::move(batch), (uint64_t)us);
+    }
+}
+
+/**
+ * Hilo de recarga: duerme hasta que la reserva baja de la mitad y la
+ * vuelve a llenar por lotes, soltando el cerrojo mientras calcula.
+ * Una excepcion que escapase del hilo llamaria a std::terminate: se
+ * cuenta y el hilo termina (sign_hash ya cubre la reserva vacia).
+ */
+void ECDSAPresigner::worker(BigInt seed) {
+    try {
+        NTLRNG rng(seed);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            cv_.wait(lock, [&]() { return stop_ || pool_.size() <= capacity_ / 2; });
+
+            while (!stop_ && pool_.size() < capacity_) {
+                size_t want = std::min(REFILL_BATCH, capacity_ - pool_.size());
+                lock.unlock();
+
+                auto start = std::chrono::steady_clock::now();
+                std::vector<Presig> batch = produce(rng, want);
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                push(std::move(batch), (uint64_t)us);
+
+                lock.lock();
+            }
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.worker_errors++;
+    }
+}
+
+// ============================================================================
+// FASE ONLINE
+// ============================================================================
+
+ECDSASignature ECDSAPresigner::sign_hash(const BigInt& hash_value,
+                                         const BigInt& private_key) {
+    const BigInt& n = curve_.n;
+    if (private_key <= 0 || private_key >= n) {
+        throw std::invalid_argument("Private key must be in range [1, n-1]");
+    }
+
+    BigInt z = truncate_hash(hash_value, n);
+
+    for (;;) {
+        Presig t;
+        bool pooled = false;
+        bool low;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!pool_.empty()) {
+                t = std::move(pool_.back());
+                pool_.pop_back();
+                stats_.served++;
+                pooled = true;
+            } else {
+                stats_.exhausted++;
+            }
+            low = pool_.size() <= capacity_ / 2;
+        }
+        if (low) cv_.notify_one();
+
+        if (!pooled) {
+            std::vector<Presig> one;
+            while (one.empty()) {
+                std::lock_guard<std::mutex> lock(rng_mutex_);
+                one = produce(*rng_, 1);
+            }
+            t = std::move(one[0]);
+        }
+
+        // s = k^-1 * (z + r*d) mod n: lo unico que depende del mensaje
+        BigInt s = MulMod(t.k_inv, (z + MulMod(t.r, private_key, n)) % n, n);
+        if (IsZero(s)) continue;
+
+        ECDSASignature sig;
+        sig.r = t.r;
+        sig.s = s;
+        sig.recovery_id = t.recovery_id;
+        return sig;
+    }
+}
+
+ECDSASignature ECDSAPresigner::sign(const std::string& message,
+                                    const BigInt& private_key) {
+    return sign_hash(SHA256::hash_to_bigint(message), private_key);
+}
+
+PresignStats ECDSAPresigner::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PresignStats out = stats_;
+    out.pool_size = pool_.size();
+    out.refill_per_sec = (refill_us_ > 0) ? stats_.produced * 1e6 / (double)refill_us_ : 0.0;
+    return out;
+}
+
+} // namespace crypto
@@ -1,6 +1,7 @@
 // main.cpp
 // Benchmark engine for RSA vs ECC comparative analysis
-// Supports: RSA, ECC (affine), ECC (Jacobian), ECC (binary fields)
+// Supports: RSA, ECC (affine), ECC (Jacobian), ECC (binary fields),
+//           prime field multiplication throughput, multi-scalar multiplication
 // Outputs structured CSV data for visualization
 // Author: Leon Elliott Fuller
 // Date: 2026-03-18
@@ -23,6 +24,7 @@
 #include "rsa.hpp"
 #include "ecc.hpp"
 #include "ecc_binary.hpp"
+#include "ecdsa_presign.hpp"
 #include "sha256.hpp"
 
 using namespace crypto;
@@ -250,6 +252,20 @@ CurveType parse_curve(const string& name) {
     throw runtime_error("Unknown prime curve: " + name);
 }
 
+FieldBackend parse_field_backend(const string& name) {
+    if (name == "ntl" || name == "NTL")                                 return FieldBackend::NTL;
+    if (name == "mont" || name == "montgomery" || name == "MONTGOMERY") return FieldBackend::MONTGOMERY;
+    throw runtime_error("Unknown field backend: " + name);
+}
+
+ScalarMethod parse_scalar_method(const string& name) {
+    if (name == "binary" || name == "BINARY") return ScalarMethod::BINARY;
+    if (name == "wnaf" || name == "WNAF")     return ScalarMethod::WNAF;
+    if (name == "ladder" || name == "LADDER") return ScalarMethod::LADDER;
+    if (name == "complete" || name == "COMPLETE") return ScalarMethod::COMPLETE;
+    throw runtime_error("Unknown scalar multiplication method: " + name);
+}
+
 // CSV-friendly curve name (no spaces or special chars)
 string csv_curve_name(CurveType type) {
     switch (type) {
@@ -311,27 +327,83 @@ vector<BenchmarkResult> benchmark_ecc(RNG& rng, CurveType curve_type,
 // ECC BENCHMARKS (PRIME FIELD - JACOBIAN COORDINATES)
 // ============================================================================
 
+// Keys per iteration of the ECCJ "keygen_batch" row
+static const size_t KEYGEN_BATCH = 100;
+
+// Signatures (each under its own key) per iteration of the ECCJ
+// "verify_batch" row; compare with VERIFY_BATCH x "verify"
+static const size_t VERIFY_BATCH = 64;
+
+// Memory cap of the per-public-key table cache in the "*_key_cache" rows
+static const size_t KEY_CACHE_BENCH_BYTES = 16 << 20;
+
 /**
  * Benchmarks the same prime field curves but using Jacobian coordinates.
  * This allows direct comparison of affine vs Jacobian performance on
  * identical operations and curve parameters.
  *
  * The algorithm label is "ECC_JACOBIAN" in CSV output so the visualization
- * pipeline can distinguish between the two coordinate systems.
+ * pipeline can distinguish between the two coordinate systems. With the
+ * fixed-width Montgomery field backend (-f mont) the label becomes
+ * "ECC_JACOBIAN_MONT", so both backends can live in the same CSV.
+ * A non-default scalar multiplication method appends its name and width,
+ * e.g. "ECC_JACOBIAN_MONT_WNAF5" for -f mont -m wnaf -w 5. The regular
+ * Montgomery ladder (-m ladder) appends "_LADDER" and the straight-line
+ * complete-formula method (-m complete) "_COMPLETE"; both also replace the
+ * fixed-base table in keygen and sign, so every row measures the regular
+ * path against the variable-time one.
+ * On secp256k1 the scalar multiplications use the GLV endomorphism and an
+ * extra "scalar_mult_no_glv" row times the same operation without it.
+ * "verify_batch" verifies VERIFY_BATCH signatures per iteration,
+ * "sign_online" times ECDSAPresigner::sign with a pre-filled nonce pool and
+ * "sign_rfc6979" signs with a deterministic (HMAC-SHA256) nonce.
+ * "verify_key_cache" and "ecdh_key_cache" repeat verify/ecdh with the
+ * per-public-key table cache enabled and the key already hot.
+ * "decode_compressed" parses a SEC1 compressed public key (one modular
+ * square root in the selected field backend). "recover" rebuilds the
+ * signer's public key from (r, s, recovery_id) and "recover_batch" does so
+ * for the VERIFY_BATCH signatures of the batch rows.
  */
 vector<BenchmarkResult> benchmark_ecc_jacobian(RNG& rng, CurveType curve_type,
-                                                int iters, bool verbose) {
+                                                int iters, bool verbose,
+                                                FieldBackend backend = FieldBackend::NTL,
+                                                ScalarMethod method = ScalarMethod::BINARY,
+                                                int wnaf_width = 4) {
     vector<BenchmarkResult> results;
     CurveParams curve = get_curve_params(curve_type);
+    curve.backend = backend;
+    curve.scalar_method = method;
+    curve.wnaf_width = wnaf_width;
     int sec = ecc_security_bits(curve_type);
     string params = csv_curve_name(curve_type);
+    string label = (backend == FieldBackend::MONTGOMERY)
+        ? "ECC_JACOBIAN_MONT" : "ECC_JACOBIAN";
+    if (method == ScalarMethod::WNAF) {
+        label += "_WNAF" + to_string(wnaf_width);
+    } else if (method == ScalarMethod::LADDER) {
+        label += "_LADDER";
+    } else if (method == ScalarMethod::COMPLETE) {
+        label += "_COMPLETE";
+    }
 
-    if (verbose) cerr << "\n[ECC-Jacobian " << params << "]\n";
+    if (verbose) {
+        cerr << "\n[ECC-Jacobian " << params
+             << (backend == FieldBackend::MONTGOMERY ? " (fixed-width 64-bit limbs)" : "")
+             << (method == ScalarMethod::WNAF ? " (wNAF w=" + to_string(wnaf_width) + ")" : "")
+             << (method == ScalarMethod::LADDER ? " (Montgomery ladder)" : "")
+             << (method == ScalarMethod::COMPLETE ? " (complete formulas)" : "")
+             << "]\n";
+    }
 
     // Key generation (Jacobian)
-    results.push_back(run_benchmark("ECC_JACOBIAN", "keygen", params, sec,
+    results.push_back(run_benchmark(label, "keygen", params, sec,
         [&]() { generate_keypair(curve, rng, true); }, iters, verbose));
 
+    // Batch key generation: KEYGEN_BATCH keys per iteration, all public keys
+    // normalized with a single shared inversion
+    results.push_back(run_benchmark(label, "keygen_batch", params, sec,
+        [&]() { generate_keypair_batch(curve, rng, KEYGEN_BATCH); }, iters, verbose));
+
     // Generate keys for remaining benchmarks (using Jacobian for consistency)
     ECKeyPair alice = generate_keypair(curve, rng, true);
     ECKeyPair bob   = generate_keypair(curve, rng, true);
@@ -339,28 +411,270 @@ vector<BenchmarkResult> benchmark_ecc_jacobian(RNG& rng, CurveType curve_type,
     // Scalar multiplication (Jacobian)
     ECPoint G(curve.Gx, curve.Gy, &curve);
     BigInt k = rng.random_range(to_ZZ(1), curve.n - 1);
-    results.push_back(run_benchmark("ECC_JACOBIAN", "scalar_mult", params, sec,
+    results.push_back(run_benchmark(label, "scalar_mult", params, sec,
         [&]() { ec_scalar_mult_jacobian(k, G); }, iters, verbose));
 
+    // Curves with an efficient endomorphism (secp256k1) use GLV automatically
+    // (unless a regular method is selected); time the same multiplication
+    // without it to quantify the gain
+    bool regular = (method == ScalarMethod::LADDER || method == ScalarMethod::COMPLETE);
+    if (curve_type == CurveType::SECP256K1 && !regular) {
+        CurveParams plain = curve;
+        plain.use_endomorphism = false;
+        ECPoint G_plain(plain.Gx, plain.Gy, &plain);
+        results.push_back(run_benchmark(label, "scalar_mult_no_glv", params, sec,
+            [&]() { ec_scalar_mult_jacobian(k, G_plain); }, iters, verbose));
+    }
+
+    // SEC1 compressed key -> point (y from a square root)
+    vector<uint8_t> bob_compressed = ec_point_encode(bob.public_key, true);
+    results.push_back(run_benchmark(label, "decode_compressed", params, sec,
+        [&]() { ec_point_decode(bob_compressed, curve); }, iters, verbose));
+
     // ECDH (Jacobian)
-    results.push_back(run_benchmark("ECC_JACOBIAN", "ecdh", params, sec,
+    results.push_back(run_benchmark(label, "ecdh", params, sec,
         [&]() { ecdh_shared_secret(alice.private_key, bob.public_key, true); },
         iters, verbose));
 
     // ECDSA Sign (Jacobian)
     string test_msg = "Benchmark test message for digital signature verification";
-    results.push_back(run_benchmark("ECC_JACOBIAN", "sign", params, sec,
+    results.push_back(run_benchmark(label, "sign", params, sec,
         [&]() { ecdsa_sign(test_msg, alice.private_key, curve, rng, true); },
         iters, verbose));
 
+    // Deterministic nonce: no RNG, the HMAC_DRBG derivation replaces it
+    results.push_back(run_benchmark(label, "sign_rfc6979", params, sec,
+        [&]() { ecdsa_sign(test_msg, alice.private_key, curve, true); },
+        iters, verbose));
+
+    // Online half of offline/online signing: the (k, r, k^-1) triples are
+    // precomputed (refill() before timing) so the row measures only
+    // s = k^-1 * (z + r*d) mod n
+    {
+        unique_ptr<RNG> nonce_rng(new NTLRNG(rng.random_bits(128)));
+        ECDSAPresigner presigner(curve, move(nonce_rng), (size_t)iters + WARMUP_RUNS + 1, false);
+        presigner.refill();
+        results.push_back(run_benchmark(label, "sign_online", params, sec,
+            [&]() { presigner.sign(test_msg, alice.private_key); },
+            iters, verbose));
+        if (verbose) {
+            PresignStats st = presigner.stats();
+            cerr << "    presign refill: " << fixed << setprecision(0) << st.refill_per_sec
+                 << " triples/s, served=" << st.served << " exhausted=" << st.exhausted
+                 << defaultfloat << endl;
+        }
+    }
+
     // ECDSA Verify (Jacobian)
     // Sign with Jacobian for consistency; the signature (r,s) is identical
     // regardless of coordinate system used internally
     ECDSASignature sig = ecdsa_sign(test_msg, alice.private_key, curve, rng, true);
-    results.push_back(run_benchmark("ECC_JACOBIAN", "verify", params, sec,
+    results.push_back(run_benchmark(label, "verify", params, sec,
         [&]() { ecdsa_verify(test_msg, sig, alice.public_key, curve, true); },
         iters, verbose));
 
+    // Same key over and over with the per-key cache on: after
+    // KEY_CACHE_HOT_USES uses (done before timing) u2*Q and d*Q run on a
+    // fixed-base table of Q. The copy shares curve.cache(), so clear the
+    // key cache afterwards
+    {
+        CurveParams cached = curve;
+        cached.key_cache_bytes = KEY_CACHE_BENCH_BYTES;
+        ECPoint alice_pub(alice.public_key.x(), alice.public_key.y(), &cached);
+        ECPoint bob_pub(bob.public_key.x(), bob.public_key.y(), &cached);
+        for (uint32_t i = 0; i < KEY_CACHE_HOT_USES; i++) {
+            ecdsa_verify(test_msg, sig, alice_pub, cached, true);
+            ecdh_shared_secret(alice.private_key, bob_pub, true);
+        }
+        results.push_back(run_benchmark(label, "verify_key_cache", params, sec,
+            [&]() { ecdsa_verify(test_msg, sig, alice_pub, cached, true); },
+            iters, verbose));
+        results.push_back(run_benchmark(label, "ecdh_key_cache", params, sec,
+            [&]() { ecdh_shared_secret(alice.private_key, bob_pub, true); },
+            iters, verbose));
+        if (verbose) {
+            KeyCacheStats st = ec_key_cache_stats(cached);
+            cerr << "    key cache: hits=" << st.hits << " misses=" << st.misses
+                 << " tables=" << st.tables << " bytes=" << st.bytes << endl;
+        }
+        ec_key_cache_clear(cached);
+    }
+
+    // Batch verification: VERIFY_BATCH signatures under distinct keys,
+    // one random linear combination checked with a multi-scalar mult
+    vector<BigInt> batch_hashes;
+    vector<ECDSASignature> batch_sigs;
+    vector<ECPoint> batch_keys;
+    for (const auto& kp : generate_keypair_batch(curve, rng, VERIFY_BATCH)) {
+        BigInt h = rng.random_bits(256);
+        batch_hashes.push_back(h);
+        batch_sigs.push_back(ecdsa_sign_hash(h, kp.private_key, curve, rng, true));
+        batch_keys.push_back(kp.public_key);
+    }
+    results.push_back(run_benchmark(label, "verify_batch", params, sec,
+        [&]() { ecdsa_verify_batch(batch_hashes, batch_sigs, batch_keys, curve, rng); },
+        iters, verbose));
+
+    // Public key recovery: single signature, then the whole batch (shared
+    // inversions for r^-1 and for the affine conversion)
+    BigInt sig_hash = SHA256::hash_to_bigint(test_msg);
+    results.push_back(run_benchmark(label, "recover", params, sec,
+        [&]() { ecdsa_recover(sig_hash, sig, curve); }, iters, verbose));
+    results.push_back(run_benchmark(label, "recover_batch", params, sec,
+        [&]() { ecdsa_recover_batch(batch_hashes, batch_sigs, curve); }, iters, verbose));
+
+    return results;
+}
+
+// ============================================================================
+// PRIME FIELD MULTIPLICATION BENCHMARKS
+// ============================================================================
+
+// Chained multiplications per timed iteration (a single field mul is far
+// below the microsecond resolution of run_benchmark)
+static const int FIELD_MUL_BATCH = 10000;
+
+template<size_t N>
+BenchmarkResult bench_fp_mul(const FpField<N>& F, const string& operation,
+                             const string& params, int sec, RNG& rng,
+                             int iters, bool verbose) {
+    typename FpField<N>::Elem x = F.from_bigint(rng.random_range(to_ZZ(1), F.modulus() - 1));
+    typename FpField<N>::Elem y = F.from_bigint(rng.random_range(to_ZZ(1), F.modulus() - 1));
+    volatile uint64_t sink = 0;
+    auto r = run_benchmark("FIELD_MUL", operation, params, sec,
+        [&]() {
+            for (int i = 0; i < FIELD_MUL_BATCH; i++) x = F.mul(x, y);
+            sink = sink + x.v[0];
+        }, iters, verbose);
+    (void)sink;
+    return r;
+}
+
+void print_field_mul_rate(const BenchmarkResult& r) {
+    double ns = r.median_us * 1000.0 / FIELD_MUL_BATCH;
+    cerr << "    " << r.operation << ": " << fixed << setprecision(1) << ns
+         << " ns/mul (" << (ns > 0 ? 1000.0 / ns : 0.0) << " Mmul/s)"
+         << defaultfloat << endl;
+}
+
+/**
+ * Measures field multiplication throughput modulo the curve prime p.
+ * Each iteration is FIELD_MUL_BATCH dependent multiplications, so
+ * avg_us / FIELD_MUL_BATCH is the latency of one mul.
+ *
+ * Rows (algorithm "FIELD_MUL"):
+ *   ntl         NTL::ZZ_p (GMP-backed, heap-allocated)
+ *   montgomery  fixed-width limbs, generic Montgomery reduction
+ *   solinas     fixed-width limbs, dedicated kernel for the curve prime
+ *               (only for P-256, P-384 and secp256k1)
+ */
+vector<BenchmarkResult> benchmark_field_mul(RNG& rng, CurveType curve_type,
+                                            int iters, bool verbose) {
+    vector<BenchmarkResult> results;
+    CurveParams curve = get_curve_params(curve_type);
+    int sec = ecc_security_bits(curve_type);
+    string params = csv_curve_name(curve_type);
+
+    if (verbose) cerr << "\n[Field mul " << params << " x" << FIELD_MUL_BATCH << "]\n";
+
+    {
+        CurveFieldScope scope(curve);
+        ZZ_p x = to_ZZ_p(rng.random_range(to_ZZ(1), curve.p - 1));
+        ZZ_p y = to_ZZ_p(rng.random_range(to_ZZ(1), curve.p - 1));
+        results.push_back(run_benchmark("FIELD_MUL", "ntl", params, sec,
+            [&]() {
+                for (int i = 0; i < FIELD_MUL_BATCH; i++) x *= y;
+            }, iters, verbose));
+    }
+
+    if (NumBits(curve.p) <= 256) {
+        FpField<4> generic(curve.p, false);
+        FpField<4> special(curve.p);
+        results.push_back(bench_fp_mul(generic, "montgomery", params, sec, rng, iters, verbose));
+        if (special.reduction() != FpReduction::MONTGOMERY) {
+            results.push_back(bench_fp_mul(special, "solinas", params, sec, rng, iters, verbose));
+        }
+    } else if (NumBits(curve.p) <= 384) {
+        FpField<6> generic(curve.p, false);
+        FpField<6> special(curve.p);
+        results.push_back(bench_fp_mul(generic, "montgomery", params, sec, rng, iters, verbose));
+        if (special.reduction() != FpReduction::MONTGOMERY) {
+            results.push_back(bench_fp_mul(special, "solinas", params, sec, rng, iters, verbose));
+        }
+    }
+
+    if (verbose) {
+        for (const auto& r : results) print_field_mul_rate(r);
+    }
+
+    return results;
+}
+
+// ============================================================================
+// MULTI-SCALAR MULTIPLICATION BENCHMARKS
+// ============================================================================
+
+// Term counts of the MSM mode; Straus and the naive loop stop earlier
+static const size_t MSM_SIZES[] = {2, 4, 8, 16, 32, 64, 128, 256, 512, 1024,
+                                   4096, 16384, 100000};
+static const size_t MSM_MAX_STRAUS = 16384;
+static const size_t MSM_MAX_NAIVE = 256;
+
+/**
+ * Benchmarks sum k_i * P_i for n = 2 .. 100000 random terms.
+ *
+ * Rows (algorithm "MSM", or "MSM_MONT" with -f mont), operation
+ * "<method>_<n>":
+ *   naive      n x ec_scalar_mult_jacobian + ec_add (n <= 256)
+ *   straus     interleaved wNAF, one table per point (n <= 16384)
+ *   pippenger  bucket method
+ * Above 64 terms the iteration count is scaled down by n/64 (minimum 1)
+ * so that the large sizes finish in reasonable time.
+ */
+vector<BenchmarkResult> benchmark_msm(RNG& rng, CurveType curve_type, int iters,
+                                      bool verbose,
+                                      FieldBackend backend = FieldBackend::NTL) {
+    vector<BenchmarkResult> results;
+    CurveParams curve = get_curve_params(curve_type);
+    curve.backend = backend;
+    int sec = ecc_security_bits(curve_type);
+    string params = csv_curve_name(curve_type);
+    string label = (backend == FieldBackend::MONTGOMERY) ? "MSM_MONT" : "MSM";
+
+    if (verbose) cerr << "\n[Multi-scalar mult " << params << "]\n";
+
+    for (size_t n : MSM_SIZES) {
+        int n_iters = (n <= 64) ? iters : max(1, (int)(iters * 64 / (long)n));
+
+        vector<BigInt> scalars;
+        vector<ECPoint> points;
+        scalars.reserve(n);
+        points.reserve(n);
+        for (const auto& kp : generate_keypair_batch(curve, rng, n)) {
+            scalars.push_back(rng.random_range(to_ZZ(1), curve.n - 1));
+            points.push_back(kp.public_key);
+        }
+        string suffix = "_" + to_string(n);
+
+        if (n <= MSM_MAX_NAIVE) {
+            results.push_back(run_benchmark(label, "naive" + suffix, params, sec,
+                [&]() {
+                    ECPoint sum(&curve);
+                    for (size_t i = 0; i < n; i++) {
+                        sum = ec_add(sum, ec_scalar_mult_jacobian(scalars[i], points[i]));
+                    }
+                }, n_iters, verbose));
+        }
+        if (n <= MSM_MAX_STRAUS) {
+            results.push_back(run_benchmark(label, "straus" + suffix, params, sec,
+                [&]() { ec_multi_scalar_mult(scalars, points, MultiScalarMethod::STRAUS); },
+                n_iters, verbose));
+        }
+        results.push_back(run_benchmark(label, "pippenger" + suffix, params, sec,
+            [&]() { ec_multi_scalar_mult(scalars, points, MultiScalarMethod::PIPPENGER); },
+            n_iters, verbose));
+    }
+
     return results;
 }
 
@@ -433,9 +747,7 @@ vector<BenchmarkResult> benchmark_ecc_binary(RNG& rng, BinaryCurveType curve_typ
     BinaryECKeyPair bob   = binary_generate_keypair(curve, rng);
 
     // Scalar multiplication
-    GF2E Gx = curve.hex_to_gf2e(curve.Gx_hex);
-    GF2E Gy = curve.hex_to_gf2e(curve.Gy_hex);
-    BinaryECPoint G(Gx, Gy, &curve);
+    BinaryECPoint G(curve.cache().Gx, curve.cache().Gy, &curve);
     BigInt k = rng.random_range(to_ZZ(1), curve.n - 1);
     results.push_back(run_benchmark("ECC_BINARY", "scalar_mult", params, sec,
         [&]() { binary_ec_scalar_mult(k, G, curve.n); }, iters, verbose));
@@ -448,6 +760,67 @@ vector<BenchmarkResult> benchmark_ecc_binary(RNG& rng, BinaryCurveType curve_typ
     return results;
 }
 
+/**
+ * Benchmarks the same binary curves using Lopez-Dahab projective
+ * coordinates (X : Y : Z) -> (X/Z, Y/Z^2), the binary-field counterpart of
+ * benchmark_ecc_jacobian: the scalar multiplication uses LD doublings and
+ * mixed LD + affine additions with a single inversion at the end.
+ *
+ * The algorithm label is "ECC_BINARY_LD" in CSV output, so the rows line
+ * up with the affine "ECC_BINARY" ones for the same curve and operation.
+ * "ecdh_ladder" computes only x(d*Q) with the x-only Lopez-Dahab
+ * Montgomery ladder (fixed bits(h*n) steps, no y recovery).
+ * On the Koblitz curves (sect*k1) keygen, scalar_mult and ecdh use the
+ * Frobenius endomorphism (width-5 tauNAF) automatically, and an extra
+ * "scalar_mult_no_frobenius" row times the same multiplication without it.
+ */
+vector<BenchmarkResult> benchmark_ecc_binary_ld(RNG& rng, BinaryCurveType curve_type,
+                                                 int iters, bool verbose) {
+    vector<BenchmarkResult> results;
+    BinaryCurveParams curve = get_binary_curve_params(curve_type);
+    int sec = binary_ecc_security_bits(curve_type);
+    string params = csv_binary_curve_name(curve_type);
+
+    if (verbose) cerr << "\n[ECC-Binary-LD " << params << " GF(2^" << curve.m << ")]\n";
+
+    curve.init_field();
+
+    // Key generation (Lopez-Dahab)
+    results.push_back(run_benchmark("ECC_BINARY_LD", "keygen", params, sec,
+        [&]() { binary_generate_keypair(curve, rng, true); }, iters, verbose));
+
+    BinaryECKeyPair alice = binary_generate_keypair(curve, rng, true);
+    BinaryECKeyPair bob   = binary_generate_keypair(curve, rng, true);
+
+    // Scalar multiplication (Lopez-Dahab)
+    BinaryECPoint G(curve.cache().Gx, curve.cache().Gy, &curve);
+    BigInt k = rng.random_range(to_ZZ(1), curve.n - 1);
+    results.push_back(run_benchmark("ECC_BINARY_LD", "scalar_mult", params, sec,
+        [&]() { binary_ec_scalar_mult_ld(k, G, curve.n); }, iters, verbose));
+
+    // Koblitz curves use tauNAF automatically; time plain LD double-and-add
+    // on the same scalar to quantify the gain
+    if (curve.cache().koblitz) {
+        BinaryCurveParams plain = curve;
+        plain.use_frobenius = false;
+        BinaryECPoint G_plain(plain.cache().Gx, plain.cache().Gy, &plain);
+        results.push_back(run_benchmark("ECC_BINARY_LD", "scalar_mult_no_frobenius", params, sec,
+            [&]() { binary_ec_scalar_mult_ld(k, G_plain, plain.n); }, iters, verbose));
+    }
+
+    // ECDH shared secret (Lopez-Dahab)
+    results.push_back(run_benchmark("ECC_BINARY_LD", "ecdh", params, sec,
+        [&]() { binary_ecdh_shared_secret(alice.private_key, bob.public_key, curve.n, true); },
+        iters, verbose));
+
+    // ECDH shared x-coordinate (x-only Montgomery ladder)
+    results.push_back(run_benchmark("ECC_BINARY_LD", "ecdh_ladder", params, sec,
+        [&]() { binary_ecdh_shared_x(alice.private_key, bob.public_key, curve.n); },
+        iters, verbose));
+
+    return results;
+}
+
 // ============================================================================
 // FULL COMPARISON MODE
 // ============================================================================
@@ -467,6 +840,8 @@ vector<BenchmarkResult> benchmark_ecc_binary(RNG& rng, BinaryCurveType curve_typ
  *    - Prime: P-256 (~128 bits), P-384 (~192 bits)
  *    - Binary: sect283k1 (~128 bits), sect233k1 (~112 bits)
  *    - Compared at equivalent security levels
+ *    - Binary curves are run in both affine and Lopez-Dahab coordinates,
+ *      so the projective rows compare like with like (Jacobian vs LD)
  */
 vector<BenchmarkResult> benchmark_comparison(RNG& rng, int iters, bool verbose) {
     vector<BenchmarkResult> all_results;
@@ -519,6 +894,13 @@ vector<BenchmarkResult> benchmark_comparison(RNG& rng, int iters, bool verbose)
         all_results.insert(all_results.end(), results.begin(), results.end());
     }
 
+    // --- Dimension 3b: ECC binary field (Lopez-Dahab) ---
+    if (verbose) cerr << "\n--- ECC binary field GF(2^m) (Lopez-Dahab coordinates) ---\n";
+    for (auto bt : binary_curves) {
+        auto results = benchmark_ecc_binary_ld(rng, bt, iters, verbose);
+        all_results.insert(all_results.end(), results.begin(), results.end());
+    }
+
     return all_results;
 }
 
@@ -534,6 +916,11 @@ void print_usage(const char* prog) {
          << "  -a ECC         Benchmark ECC (affine coordinates, prime field)\n"
          << "  -a ECCJ        Benchmark ECC (Jacobian coordinates, prime field)\n"
          << "  -a BIN         Benchmark ECC (binary field GF(2^m))\n"
+         << "  -a BINLD       Benchmark ECC (Lopez-Dahab coordinates, binary field)\n"
+         << "  -a FIELD       Prime field multiplication throughput (NTL vs\n"
+         << "                 Montgomery vs dedicated reduction) for -c CURVE\n"
+         << "  -a MSM         Multi-scalar multiplication, n = 2 .. 100000 terms\n"
+         << "                 (naive vs Straus vs Pippenger; honours -f)\n"
          << "  -a CMP         Full comparison (all algorithms, all coordinates)\n"
          << "\n"
          << "Parameters:\n"
@@ -542,6 +929,13 @@ void print_usage(const char* prog) {
          << "                 Prime: secp256k1, P-256, P-384\n"
          << "                 Binary: sect163k1, sect233k1, sect283k1,\n"
          << "                         sect233r1, sect283r1\n"
+         << "  -f FIELD       Prime field backend for ECCJ: ntl or mont (default: ntl)\n"
+         << "                 mont = fixed 4x64/6x64-bit limbs (Montgomery, or the\n"
+         << "                 dedicated reduction for P-256/P-384/secp256k1)\n"
+         << "  -m METHOD      Scalar multiplication for ECCJ: binary, wnaf, ladder\n"
+         << "                 (regular co-Z Montgomery ladder) or complete\n"
+         << "                 (Renes-Costello-Batina formulas; default: binary)\n"
+         << "  -w WIDTH       wNAF window width, 2-7 (default: 4)\n"
          << "  -i ITERS       Iterations per benchmark (default: 10)\n"
          << "  -s MODE        Seed mode: fixed or random (default: fixed)\n"
          << "  -r FILE        Output raw per-iteration CSV to FILE\n"
@@ -557,7 +951,12 @@ void print_usage(const char* prog) {
          << "  " << prog << " -a RSA -b 4096 -i 50 -r raw.csv > summary.csv\n"
          << "  " << prog << " -a ECC -c P-384 -i 30 -v > ecc_p384.csv\n"
          << "  " << prog << " -a ECCJ -c P-256 -i 30 -v > ecc_jacobian.csv\n"
-         << "  " << prog << " -a BIN -c sect283k1 -i 10 -v > binary.csv\n";
+         << "  " << prog << " -a ECCJ -c P-256 -f mont -i 30 -v > ecc_mont.csv\n"
+         << "  " << prog << " -a ECCJ -c P-256 -m wnaf -w 5 -i 30 -v > ecc_wnaf.csv\n"
+         << "  " << prog << " -a BIN -c sect283k1 -i 10 -v > binary.csv\n"
+         << "  " << prog << " -a BINLD -c sect283k1 -i 10 -v > binary_ld.csv\n"
+         << "  " << prog << " -a FIELD -c P-384 -i 30 -v > field_mul.csv\n"
+         << "  " << prog << " -a MSM -c P-256 -f mont -i 64 -v > msm.csv\n";
 }
 
 int main(int argc, char** argv) {
@@ -567,14 +966,20 @@ int main(int argc, char** argv) {
     int iterations = 10;
     string seed_mode = "fixed";
     string raw_file = "";
+    string field_name = "ntl";
+    string method_name = "binary";
+    int wnaf_width = 4;
     bool verbose = false;
 
     int opt;
-    while ((opt = getopt(argc, argv, "a:b:c:i:s:r:vh")) != -1) {
+    while ((opt = getopt(argc, argv, "a:b:c:f:m:w:i:s:r:vh")) != -1) {
         switch (opt) {
             case 'a': algo = optarg; break;
             case 'b': bits = stoi(optarg); break;
             case 'c': curve_name = optarg; break;
+            case 'f': field_name = optarg; break;
+            case 'm': method_name = optarg; break;
+            case 'w': wnaf_width = stoi(optarg); break;
             case 'i': iterations = stoi(optarg); break;
             case 's': seed_mode = optarg; break;
             case 'r': raw_file = optarg; break;
@@ -587,8 +992,14 @@ int main(int argc, char** argv) {
     }
 
     if (algo != "RSA" && algo != "ECC" && algo != "ECCJ"
-        && algo != "BIN" && algo != "CMP") {
-        cerr << "Error: Algorithm must be RSA, ECC, ECCJ, BIN, or CMP\n";
+        && algo != "BIN" && algo != "BINLD" && algo != "FIELD" && algo != "MSM"
+        && algo != "CMP") {
+        cerr << "Error: Algorithm must be RSA, ECC, ECCJ, BIN, BINLD, FIELD, MSM, or CMP\n";
+        return 1;
+    }
+
+    if (wnaf_width < 2 || wnaf_width > 7) {
+        cerr << "Error: wNAF width must be between 2 and 7\n";
         return 1;
     }
 
@@ -613,10 +1024,22 @@ int main(int argc, char** argv) {
             results = benchmark_ecc(rng, ct, iterations, verbose);
         } else if (algo == "ECCJ") {
             CurveType ct = parse_curve(curve_name);
-            results = benchmark_ecc_jacobian(rng, ct, iterations, verbose);
+            FieldBackend fb = parse_field_backend(field_name);
+            ScalarMethod sm = parse_scalar_method(method_name);
+            results = benchmark_ecc_jacobian(rng, ct, iterations, verbose, fb, sm, wnaf_width);
         } else if (algo == "BIN") {
             BinaryCurveType bt = parse_binary_curve(curve_name);
             results = benchmark_ecc_binary(rng, bt, iterations, verbose);
+        } else if (algo == "BINLD") {
+            BinaryCurveType bt = parse_binary_curve(curve_name);
+            results = benchmark_ecc_binary_ld(rng, bt, iterations, verbose);
+        } else if (algo == "FIELD") {
+            CurveType ct = parse_curve(curve_name);
+            results = benchmark_field_mul(rng, ct, iterations, verbose);
+        } else if (algo == "MSM") {
+            CurveType ct = parse_curve(curve_name);
+            FieldBackend fb = parse_field_backend(field_name);
+            results = benchmark_msm(rng, ct, iterations, verbose, fb);
         } else {
             results = benchmark_comparison(rng, iterations, verbose);
         }
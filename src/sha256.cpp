@@ -309,4 +309,47 @@ BigInt SHA256::hash_to_bigint(const std::string &message) {
   return hash(message).to_bigint();
 }
 
+// ============================================================================
+// HMAC-SHA256 (RFC 2104)
+// ============================================================================
+
+SHA256Digest SHA256::hmac(const std::vector<uint8_t> &key,
+                          const uint8_t *data, size_t length) {
+  constexpr uint8_t IPAD = 0x36;
+  constexpr uint8_t OPAD = 0x5c;
+
+  // K0: clave de BLOCK_BYTES bytes (hash previo si es mas larga)
+  uint8_t k0[BLOCK_BYTES] = {0};
+  if (key.size() > BLOCK_BYTES) {
+    SHA256Digest kh = hash(key);
+    std::memcpy(k0, kh.bytes.data(), kh.bytes.size());
+  } else if (!key.empty()) {
+    std::memcpy(k0, key.data(), key.size());
+  }
+
+  // Hash interno: H((K0 ^ ipad) || m)
+  std::vector<uint8_t> inner(BLOCK_BYTES + length);
+  for (size_t i = 0; i < BLOCK_BYTES; ++i) {
+    inner[i] = k0[i] ^ IPAD;
+  }
+  if (length > 0) {
+    std::memcpy(inner.data() + BLOCK_BYTES, data, length);
+  }
+  SHA256Digest inner_hash = hash(inner);
+
+  // Hash externo: H((K0 ^ opad) || hash interno)
+  std::vector<uint8_t> outer(BLOCK_BYTES + inner_hash.bytes.size());
+  for (size_t i = 0; i < BLOCK_BYTES; ++i) {
+    outer[i] = k0[i] ^ OPAD;
+  }
+  std::memcpy(outer.data() + BLOCK_BYTES, inner_hash.bytes.data(),
+              inner_hash.bytes.size());
+  return hash(outer);
+}
+
+SHA256Digest SHA256::hmac(const std::vector<uint8_t> &key,
+                          const std::vector<uint8_t> &data) {
+  return hmac(key, data.data(), data.size());
+}
+
 } // namespace crypto
\ No newline at end of file